@@ -0,0 +1,200 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BrowserEntryIndex.h"
+
+#include "core/Global.h"
+#include "core/Group.h"
+#include "core/UrlTools.h"
+
+#include <QUrl>
+
+#include <algorithm>
+
+namespace
+{
+    bool isUrlAttribute(const QString& key)
+    {
+        return key == EntryAttributes::URLKey || key.startsWith(EntryAttributes::AdditionalUrlAttribute)
+               || key == QString("%1_RELYING_PARTY").arg(EntryAttributes::PasskeyAttribute);
+    }
+
+    // Position of an entry in a pre-order walk of the tree, or false if it is not below root
+    bool treePosition(const Entry* entry, const Group* root, QVector<int>& position)
+    {
+        const Group* group = entry->group();
+        if (!group) {
+            return false;
+        }
+
+        // Entries of a group come before the entries of its subgroups
+        position = {group->entries().indexOf(const_cast<Entry*>(entry)), -1};
+        for (; group != root; group = group->parentGroup()) {
+            const Group* parent = group->parentGroup();
+            if (!parent) {
+                return false;
+            }
+            position.append(parent->children().indexOf(const_cast<Group*>(group)));
+        }
+        std::reverse(position.begin(), position.end());
+        return true;
+    }
+} // namespace
+
+BrowserEntryIndex::BrowserEntryIndex(Database* db)
+    : QObject(db)
+    , m_db(db)
+{
+    connect(db, &Database::entryAdded, this, &BrowserEntryIndex::addEntry);
+    connect(db, &Database::entryRemoved, this, &BrowserEntryIndex::removeEntry);
+
+    for (auto entry : db->rootGroup()->entriesRecursive()) {
+        addEntry(entry);
+    }
+}
+
+/**
+ * Get the index of a database, creating it on first use.
+ */
+BrowserEntryIndex* BrowserEntryIndex::forDatabase(Database* db)
+{
+    Q_ASSERT(db);
+
+    auto index = db->findChild<BrowserEntryIndex*>(QString(), Qt::FindDirectChildrenOnly);
+    if (!index) {
+        index = new BrowserEntryIndex(db);
+    }
+    return index;
+}
+
+/**
+ * Find all entries of the database that may match a site with the given host.
+ *
+ * Entries with placeholders in their URLs are always returned since their
+ * resolved values may change without the entry being modified.
+ *
+ * @param host host name of the site
+ * @return candidate entries in tree order
+ */
+QList<Entry*> BrowserEntryIndex::candidates(const QString& host)
+{
+    update();
+
+    auto entries = m_unindexable;
+    if (!host.isEmpty()) {
+        entries.unite(m_domains.value(urlTools()->getBaseDomainFromUrl(host)));
+    }
+
+    using PositionedEntry = QPair<QVector<int>, Entry*>;
+    QList<PositionedEntry> sorted;
+    QVector<int> position;
+    for (auto entry : asConst(entries)) {
+        if (treePosition(entry, m_db->rootGroup(), position)) {
+            sorted.append({position, entry});
+        }
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const PositionedEntry& lhs, const PositionedEntry& rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    QList<Entry*> result;
+    for (const auto& item : asConst(sorted)) {
+        result.append(item.second);
+    }
+    return result;
+}
+
+void BrowserEntryIndex::addEntry(Entry* entry)
+{
+    connect(entry, &Entry::modified, this, [this, entry] { m_dirty.insert(entry); });
+    m_dirty.insert(entry);
+}
+
+void BrowserEntryIndex::removeEntry(Entry* entry)
+{
+    disconnect(entry, nullptr, this, nullptr);
+    m_dirty.remove(entry);
+    unindexEntry(entry);
+}
+
+/**
+ * Re-index all entries that have been added or modified since the last lookup.
+ */
+void BrowserEntryIndex::update()
+{
+    for (auto entry : asConst(m_dirty)) {
+        unindexEntry(entry);
+        indexEntry(entry);
+    }
+    m_dirty.clear();
+}
+
+void BrowserEntryIndex::indexEntry(Entry* entry)
+{
+    const auto attributes = entry->attributes();
+    for (const auto& key : attributes->keys()) {
+        if (isUrlAttribute(key) && attributes->value(key).contains('{')) {
+            m_unindexable.insert(entry);
+            return;
+        }
+    }
+
+    QStringList domains;
+    for (const auto& url : entry->getAllUrls()) {
+        // Same interpretation of the entry URL as BrowserService::handleURL()
+        const auto host = url.contains("://") ? QUrl(url).host() : QUrl::fromUserInput(url).host();
+        if (host.isEmpty()) {
+            continue;
+        }
+
+        domains << baseDomain(host);
+        if (host.contains("www.")) {
+            domains << baseDomain(QString(host).remove("www."));
+        }
+    }
+    domains.removeDuplicates();
+
+    for (const auto& domain : asConst(domains)) {
+        m_domains[domain].insert(entry);
+    }
+    m_entryDomains.insert(entry, domains);
+}
+
+void BrowserEntryIndex::unindexEntry(Entry* entry)
+{
+    m_unindexable.remove(entry);
+
+    const auto domains = m_entryDomains.take(entry);
+    for (const auto& domain : domains) {
+        auto it = m_domains.find(domain);
+        if (it != m_domains.end()) {
+            it->remove(entry);
+            if (it->isEmpty()) {
+                m_domains.erase(it);
+            }
+        }
+    }
+}
+
+QString BrowserEntryIndex::baseDomain(const QString& host)
+{
+    auto it = m_baseDomains.constFind(host);
+    if (it == m_baseDomains.constEnd()) {
+        it = m_baseDomains.insert(host, urlTools()->getBaseDomainFromUrl(host));
+    }
+    return it.value();
+}
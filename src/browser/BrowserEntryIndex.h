@@ -0,0 +1,64 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_BROWSERENTRYINDEX_H
+#define KEEPASSXC_BROWSERENTRYINDEX_H
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+
+class Database;
+class Entry;
+
+/**
+ * Index of the entries of a database by the base domain of their URLs.
+ *
+ * Covers the URL, additional URLs and passkey relying party of every entry.
+ * Only narrows down the entries a browser request has to look at, the caller
+ * still has to match every candidate against the site URL. The index is attached
+ * to its database and re-indexes modified entries lazily on the next lookup.
+ */
+class BrowserEntryIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    static BrowserEntryIndex* forDatabase(Database* db);
+
+    QList<Entry*> candidates(const QString& host);
+
+private:
+    explicit BrowserEntryIndex(Database* db);
+
+    void addEntry(Entry* entry);
+    void removeEntry(Entry* entry);
+    void update();
+    void indexEntry(Entry* entry);
+    void unindexEntry(Entry* entry);
+    QString baseDomain(const QString& host);
+
+    Database* const m_db;
+    QHash<QString, QSet<Entry*>> m_domains;
+    QHash<Entry*, QStringList> m_entryDomains;
+    QSet<Entry*> m_unindexable;
+    QSet<Entry*> m_dirty;
+    QHash<QString, QString> m_baseDomains;
+};
+
+#endif // KEEPASSXC_BROWSERENTRYINDEX_H
@@ -20,6 +20,7 @@
 #include "BrowserService.h"
 #include "BrowserAction.h"
 #include "BrowserEntryConfig.h"
+#include "BrowserEntryIndex.h"
 #include "BrowserEntrySaveDialog.h"
 #include "BrowserHost.h"
 #include "BrowserMessageBuilder.h"
@@ -957,44 +958,58 @@ QList<Entry*> BrowserService::searchEntries(const QSharedPointer<Database>& db,
         return entries;
     }
 
-    for (const auto& group : rootGroup->groupsRecursive(true)) {
-        if (group->isRecycled()
-            || group->resolveCustomDataTriState(BrowserService::OPTION_HIDE_ENTRY) == Group::Enable) {
-            continue;
+    // Special URLs are not matched by host, check every entry for them
+    QList<Entry*> candidates;
+    if (siteUrl.startsWith("file://") || siteUrl.startsWith("keepassxc://")) {
+        candidates = rootGroup->entriesRecursive();
+    } else {
+        candidates = BrowserEntryIndex::forDatabase(db.data())->candidates(QUrl::fromUserInput(siteUrl).host());
+    }
+
+    struct GroupOptions
+    {
+        bool excluded;
+        bool omitWwwSubdomain;
+    };
+    QHash<const Group*, GroupOptions> groupOptions;
+
+    for (auto* entry : asConst(candidates)) {
+        const auto* group = entry->group();
+        auto options = groupOptions.constFind(group);
+        if (options == groupOptions.constEnd()) {
+            // If a key restriction is specified and not contained in the keys list then skip this group.
+            const auto restrictKey = group->resolveCustomDataString(BrowserService::OPTION_RESTRICT_KEY);
+            const bool excluded =
+                group->isRecycled()
+                || group->resolveCustomDataTriState(BrowserService::OPTION_HIDE_ENTRY) == Group::Enable
+                || (!restrictKey.isEmpty() && !keys.contains(restrictKey));
+            const bool omitWwwSubdomain =
+                group->resolveCustomDataTriState(BrowserService::OPTION_OMIT_WWW) == Group::Enable;
+            options = groupOptions.insert(group, {excluded, omitWwwSubdomain});
         }
 
-        // If a key restriction is specified and not contained in the keys list then skip this group.
-        auto restrictKey = group->resolveCustomDataString(BrowserService::OPTION_RESTRICT_KEY);
-        if (!restrictKey.isEmpty() && !keys.contains(restrictKey)) {
+        if (options->excluded) {
             continue;
         }
 
-        const auto omitWwwSubdomain =
-            group->resolveCustomDataTriState(BrowserService::OPTION_OMIT_WWW) == Group::Enable;
-
-        for (auto* entry : group->entries()) {
-            if (entry->isRecycled()
-                || (entry->customData()->contains(BrowserService::OPTION_HIDE_ENTRY)
-                    && entry->customData()->value(BrowserService::OPTION_HIDE_ENTRY) == TRUE_STR)) {
-                continue;
-            }
+        if (entry->isRecycled()
+            || (entry->customData()->contains(BrowserService::OPTION_HIDE_ENTRY)
+                && entry->customData()->value(BrowserService::OPTION_HIDE_ENTRY) == TRUE_STR)) {
+            continue;
+        }
 
-            if (!passkey && !shouldIncludeEntry(entry, siteUrl, formUrl, omitWwwSubdomain)) {
-                continue;
-            }
+        if (!passkey && !shouldIncludeEntry(entry, siteUrl, formUrl, options->omitWwwSubdomain)) {
+            continue;
+        }
 
 #ifdef WITH_XC_BROWSER_PASSKEYS
-            // With Passkeys, check for the Relying Party instead of URL
-            if (passkey && entry->attributes()->value(BrowserPasskeys::KPEX_PASSKEY_RELYING_PARTY) != siteUrl) {
-                continue;
-            }
+        // With Passkeys, check for the Relying Party instead of URL
+        if (passkey && entry->attributes()->value(BrowserPasskeys::KPEX_PASSKEY_RELYING_PARTY) != siteUrl) {
+            continue;
+        }
 #endif
 
-            // Additional URL check may have already inserted the entry to the list
-            if (!entries.contains(entry)) {
-                entries.append(entry);
-            }
-        }
+        entries.append(entry);
     }
 
     return entries;
@@ -132,3 +132,8 @@ int Add::executeWithDatabase(QSharedPointer<Database> database, QSharedPointer<Q
     }
     return EXIT_SUCCESS;
 }
+
+bool Add::canRunInAgent(QSharedPointer<QCommandLineParser> parser) const
+{
+    return !parser->isSet(Add::PasswordPromptOption);
+}
@@ -26,6 +26,7 @@ public:
     Add();
 
     int executeWithDatabase(QSharedPointer<Database> db, QSharedPointer<QCommandLineParser> parser) override;
+    bool canRunInAgent(QSharedPointer<QCommandLineParser> parser) const override;
 
     static const QCommandLineOption UsernameOption;
     static const QCommandLineOption UrlOption;
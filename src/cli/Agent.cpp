@@ -0,0 +1,536 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Agent.h"
+
+#include "DatabaseCommand.h"
+#include "Utils.h"
+#include "config-keepassx.h"
+
+#include <QBuffer>
+#include <QCommandLineParser>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFileInfo>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QSignalBlocker>
+#include <QStandardPaths>
+#include <QTimer>
+
+#include <limits>
+
+namespace
+{
+    const quint32 ProtocolVersion = 2;
+    const int ConnectTimeoutMSec = 500;
+    // The agent serves one client at a time, a client waiting longer runs the command itself
+    const int BusyTimeoutMSec = 5000;
+    const int CommandTimeoutMSec = 300000;
+    const int DefaultTimeoutSeconds = 900;
+
+    // A command is only run once the client confirmed that it did not give up waiting for the agent
+    const QByteArray ReadyMessage = QByteArrayLiteral("ready");
+    const QByteArray ConfirmMessage = QByteArrayLiteral("confirm");
+
+    const QString StartAction = QStringLiteral("start");
+    const QString StopAction = QStringLiteral("stop");
+    const QString RunAction = QStringLiteral("run");
+
+    /**
+     * Messages are sent as a size followed by the payload, see QDataStream for the format.
+     */
+    bool writeMessage(QLocalSocket* socket, const QByteArray& message)
+    {
+        QByteArray frame;
+        QDataStream stream(&frame, QIODevice::WriteOnly);
+        stream << message;
+        return socket->write(frame) == frame.size();
+    }
+
+    /**
+     * Take a complete message from the socket without blocking.
+     *
+     * @return false if the message has not been received completely yet
+     */
+    bool takeMessage(QLocalSocket* socket, QByteArray& message)
+    {
+        quint32 size = 0;
+        if (socket->bytesAvailable() < static_cast<qint64>(sizeof(size))) {
+            return false;
+        }
+        QDataStream header(socket->peek(sizeof(size)));
+        header >> size;
+        // A null byte array is sent as a size of 0xffffffff without payload
+        if (size != 0xffffffff && socket->bytesAvailable() < static_cast<qint64>(sizeof(size)) + size) {
+            return false;
+        }
+
+        QDataStream stream(socket);
+        stream >> message;
+        return stream.status() == QDataStream::Ok;
+    }
+
+    /**
+     * Wait for a complete message from the socket.
+     *
+     * @return false if the message was not received within the timeout
+     */
+    bool readMessage(QLocalSocket* socket, QByteArray& message, int timeoutMSec)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        while (!takeMessage(socket, message)) {
+            const qint64 remaining = timeoutMSec - timer.elapsed();
+            if (remaining <= 0 || !socket->waitForReadyRead(static_cast<int>(remaining))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool sendRequest(QLocalSocket* socket, const QByteArray& request, QByteArray& response, int timeoutMSec)
+    {
+        if (!writeMessage(socket, request)
+            || (socket->bytesToWrite() > 0 && !socket->waitForBytesWritten(timeoutMSec))) {
+            return false;
+        }
+        return readMessage(socket, response, timeoutMSec);
+    }
+
+    class AgentServer
+    {
+    public:
+        AgentServer(QSharedPointer<Database> db, int timeout)
+            : m_db(std::move(db))
+            , m_lastModified(QFileInfo(m_db->filePath()).lastModified())
+        {
+            m_server.setSocketOptions(QLocalServer::UserAccessOption);
+            m_idleTimer.setSingleShot(true);
+            m_idleTimer.setInterval(timeout * 1000);
+            QObject::connect(&m_idleTimer, &QTimer::timeout, &m_loop, &QEventLoop::quit);
+            QObject::connect(&m_server, &QLocalServer::newConnection, &m_server, [this] { acceptConnections(); });
+        }
+
+        bool listen(const QString& serverName)
+        {
+            if (m_server.listen(serverName)) {
+                return true;
+            }
+
+            QLocalSocket socket;
+            socket.connectToServer(serverName);
+            if (socket.waitForConnected(ConnectTimeoutMSec)) {
+                m_errorString = QObject::tr("An agent is already running for %1.").arg(m_db->filePath());
+                return false;
+            }
+
+            // Left behind by an agent that did not exit cleanly
+            QLocalServer::removeServer(serverName);
+            if (!m_server.listen(serverName)) {
+                m_errorString = QObject::tr("Failed to start the agent: %1").arg(m_server.errorString());
+                return false;
+            }
+            return true;
+        }
+
+        QString errorString() const
+        {
+            return m_errorString;
+        }
+
+        void exec()
+        {
+            m_idleTimer.start();
+            m_loop.exec();
+            m_server.close();
+        }
+
+    private:
+        void acceptConnections()
+        {
+            while (QLocalSocket* socket = m_server.nextPendingConnection()) {
+                QObject::connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+                QObject::connect(socket, &QLocalSocket::readyRead, socket, [this, socket] { processRequest(socket); });
+                processRequest(socket);
+            }
+        }
+
+        void processRequest(QLocalSocket* socket)
+        {
+            QByteArray request;
+            if (!takeMessage(socket, request)) {
+                return;
+            }
+            m_idleTimer.start();
+
+            quint32 version = 0;
+            QString action;
+            QDataStream requestStream(request);
+            requestStream >> version >> action;
+
+            bool handled = false;
+            int exitCode = EXIT_FAILURE;
+            QByteArray output;
+            QByteArray errorOutput;
+            bool stop = false;
+            if (version != ProtocolVersion) {
+                // Let the client open the database itself
+            } else if (action == StopAction) {
+                handled = true;
+                exitCode = EXIT_SUCCESS;
+                stop = true;
+            } else if (action == RunAction) {
+                QStringList arguments;
+                QString workingDirectory;
+                requestStream >> arguments >> workingDirectory;
+                if (!confirmRun(socket)) {
+                    // The client gave up waiting and runs the command itself
+                    socket->abort();
+                    return;
+                }
+                if (reloadIfChanged()) {
+                    handled = runCommand(arguments, workingDirectory, exitCode, output, errorOutput);
+                    if (handled && !discardUnsavedChanges(exitCode)) {
+                        stop = true;
+                    }
+                } else {
+                    stop = true;
+                }
+            }
+
+            QByteArray response;
+            QDataStream responseStream(&response, QIODevice::WriteOnly);
+            responseStream << handled << exitCode << output << errorOutput;
+            writeMessage(socket, response);
+
+            if (stop) {
+                socket->waitForBytesWritten(ConnectTimeoutMSec);
+                m_loop.quit();
+            }
+        }
+
+        /**
+         * Tell the client that the agent is ready to run its command and wait for it to confirm
+         * that it still wants the agent to run it.
+         */
+        bool confirmRun(QLocalSocket* socket)
+        {
+            // Waiting must not process the confirmation as another request
+            QSignalBlocker blocker(socket);
+            QByteArray confirmation;
+            return sendRequest(socket, ReadyMessage, confirmation, ConnectTimeoutMSec)
+                   && confirmation == ConfirmMessage;
+        }
+
+        /**
+         * Pick up changes made to the database file by anyone else, the key is reused for that.
+         *
+         * @return false if the database could not be reopened, the agent must not serve it anymore
+         */
+        bool reloadIfChanged()
+        {
+            if (QFileInfo(m_db->filePath()).lastModified() == m_lastModified) {
+                return true;
+            }
+            return reopen();
+        }
+
+        /**
+         * A command that failed or did not save leaves changes behind that a command run
+         * without the agent would have dropped on exit, read the database file again then.
+         *
+         * @return false if the database could not be reopened, the agent must not serve it anymore
+         */
+        bool discardUnsavedChanges(int exitCode)
+        {
+            if (exitCode == EXIT_SUCCESS && !m_db->isModified()) {
+                return true;
+            }
+            return reopen();
+        }
+
+        bool reopen()
+        {
+            auto db = QSharedPointer<Database>::create();
+            QString error;
+            if (!db->open(m_db->filePath(), m_db->key(), &error)) {
+                Utils::STDERR << QObject::tr("Failed to reopen the database: %1").arg(error) << endl;
+                return false;
+            }
+            m_db = db;
+            m_lastModified = QFileInfo(m_db->filePath()).lastModified();
+            return true;
+        }
+
+        /**
+         * Run a database command with the unlocked database, the output of the command is
+         * captured instead of being written to the streams of the agent.
+         *
+         * @return false if the agent cannot run the command, the client opens the database itself then
+         */
+        bool runCommand(const QStringList& arguments,
+                        const QString& workingDirectory,
+                        int& exitCode,
+                        QByteArray& output,
+                        QByteArray& errorOutput)
+        {
+            auto command = Commands::getCommand(arguments.value(0)).dynamicCast<DatabaseCommand>();
+            if (!command) {
+                return false;
+            }
+
+            // Relative paths in the arguments refer to the working directory of the client
+            const QString agentDirectory = QDir::currentPath();
+            if (!QDir::setCurrent(workingDirectory)) {
+                return false;
+            }
+
+            QBuffer outBuffer(&output);
+            outBuffer.open(QIODevice::WriteOnly);
+            QBuffer errBuffer(&errorOutput);
+            errBuffer.open(QIODevice::WriteOnly);
+            // Commands that prompt for input are never forwarded, the agent has no terminal
+            QBuffer inBuffer;
+            inBuffer.open(QIODevice::ReadOnly);
+
+            QIODevice* outDevice = Utils::STDOUT.device();
+            QIODevice* errDevice = Utils::STDERR.device();
+            QIODevice* inDevice = Utils::STDIN.device();
+            Utils::STDOUT.setDevice(&outBuffer);
+            Utils::STDERR.setDevice(&errBuffer);
+            Utils::STDIN.setDevice(&inBuffer);
+
+            bool handled = false;
+            auto parser = command->getCommandLineParser(arguments);
+            if (parser.isNull()) {
+                exitCode = EXIT_FAILURE;
+                handled = true;
+            } else if (command->canRunInAgent(parser)
+                       && QFileInfo(parser->positionalArguments().at(0)).canonicalFilePath()
+                              == QFileInfo(m_db->filePath()).canonicalFilePath()) {
+                // Only a save of the agent moves the modification time on, anything else
+                // that changed the file meanwhile is picked up by the next request
+                bool saved = false;
+                auto connection = QObject::connect(
+                    m_db.data(), &Database::databaseSaved, m_db.data(), [&saved] { saved = true; });
+                exitCode = command->executeWithDatabase(m_db, parser);
+                QObject::disconnect(connection);
+                if (saved) {
+                    m_lastModified = QFileInfo(m_db->filePath()).lastModified();
+                }
+                handled = true;
+            }
+
+            // Setting the devices flushes the captured output
+            Utils::STDOUT.setDevice(outDevice);
+            Utils::STDERR.setDevice(errDevice);
+            Utils::STDIN.setDevice(inDevice);
+            QDir::setCurrent(agentDirectory);
+
+            if (!handled) {
+                output.clear();
+                errorOutput.clear();
+            }
+            return handled;
+        }
+
+        QSharedPointer<Database> m_db;
+        QDateTime m_lastModified;
+        QLocalServer m_server;
+        QTimer m_idleTimer;
+        QEventLoop m_loop;
+        QString m_errorString;
+    };
+} // namespace
+
+const QCommandLineOption Agent::TimeoutOption =
+    QCommandLineOption(QStringList() << "t"
+                                     << "timeout",
+                       QObject::tr("Stop the agent after it was idle for the given number of seconds (default: %1).")
+                           .arg(DefaultTimeoutSeconds),
+                       QObject::tr("seconds"),
+                       QString::number(DefaultTimeoutSeconds));
+
+Agent::Agent()
+{
+    name = QString("agent");
+    description = QObject::tr("Keep a database unlocked for other commands.");
+    positionalArguments.append({QString("action"), QObject::tr("Either start or stop."), QString("start|stop")});
+    positionalArguments.append({QString("database"), QObject::tr("Path of the database."), QString("")});
+    options.append(Command::KeyFileOption);
+    options.append(Command::NoPasswordOption);
+#ifdef WITH_XC_YUBIKEY
+    options.append(Command::YubiKeyOption);
+#endif
+    options.append(Agent::TimeoutOption);
+}
+
+int Agent::execute(const QStringList& arguments)
+{
+    QSharedPointer<QCommandLineParser> parser = getCommandLineParser(arguments);
+    if (parser.isNull()) {
+        return EXIT_FAILURE;
+    }
+
+    auto& out = parser->isSet(Command::QuietOption) ? Utils::DEVNULL : Utils::STDOUT;
+    auto& err = Utils::STDERR;
+
+    const QStringList args = parser->positionalArguments();
+    const QString& action = args.at(0);
+    const QString& databaseFilename = args.at(1);
+
+    if (action == StopAction) {
+        int exitCode = EXIT_FAILURE;
+        QLocalSocket socket;
+        socket.connectToServer(serverName(databaseFilename));
+        if (socket.waitForConnected(ConnectTimeoutMSec)) {
+            QByteArray request;
+            QDataStream requestStream(&request, QIODevice::WriteOnly);
+            requestStream << ProtocolVersion << StopAction;
+            QByteArray response;
+            if (sendRequest(&socket, request, response, CommandTimeoutMSec)) {
+                bool handled = false;
+                QDataStream responseStream(response);
+                responseStream >> handled >> exitCode;
+            }
+        }
+        if (exitCode != EXIT_SUCCESS) {
+            err << QObject::tr("No agent is running for %1.").arg(databaseFilename) << endl;
+            return EXIT_FAILURE;
+        }
+        out << QObject::tr("Stopped the agent for %1.").arg(databaseFilename) << endl;
+        return EXIT_SUCCESS;
+    }
+
+    if (action != StartAction) {
+        err << QObject::tr("Invalid action %1.").arg(action) << endl;
+        return EXIT_FAILURE;
+    }
+
+    bool ok = false;
+    const int timeout = parser->value(Agent::TimeoutOption).toInt(&ok);
+    if (!ok || timeout <= 0 || timeout > std::numeric_limits<int>::max() / 1000) {
+        err << QObject::tr("Invalid timeout value %1.").arg(parser->value(Agent::TimeoutOption)) << endl;
+        return EXIT_FAILURE;
+    }
+
+    auto db = Utils::unlockDatabase(databaseFilename,
+                                    !parser->isSet(Command::NoPasswordOption),
+                                    parser->value(Command::KeyFileOption),
+#ifdef WITH_XC_YUBIKEY
+                                    parser->value(Command::YubiKeyOption),
+#else
+                                    "",
+#endif
+                                    parser->isSet(Command::QuietOption));
+    if (!db) {
+        return EXIT_FAILURE;
+    }
+
+    AgentServer server(db, timeout);
+    db.reset();
+    if (!server.listen(serverName(databaseFilename))) {
+        err << server.errorString() << endl;
+        return EXIT_FAILURE;
+    }
+
+    out << QObject::tr("Agent started for %1.").arg(databaseFilename) << endl;
+    server.exec();
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Name of the local socket the agent of the given database listens on.
+ *
+ * @return an empty string if the database file does not exist
+ */
+QString Agent::serverName(const QString& databaseFilename)
+{
+    const QString canonicalPath = QFileInfo(databaseFilename).canonicalFilePath();
+    if (canonicalPath.isEmpty()) {
+        return {};
+    }
+
+    // One agent per database file, a digest of the path keeps the socket path short
+    const auto digest = QCryptographicHash::hash(canonicalPath.toUtf8(), QCryptographicHash::Sha256).toHex().left(16);
+    const QString serverName = QStringLiteral("org.keepassxc.KeePassXC.CliAgent-") + QString::fromLatin1(digest);
+#if defined(Q_OS_WIN)
+    // Windows uses named pipes
+    return serverName + "_" + qgetenv("USERNAME");
+#else
+    // This returns XDG_RUNTIME_DIR or else a temporary directory only accessible by the user
+    return QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation) + "/" + serverName;
+#endif
+}
+
+/**
+ * Let the agent of the given database run a command, its output is written to the streams
+ * of this process.
+ *
+ * @return false if there is no agent that can run the command
+ */
+bool Agent::forwardCommand(const QString& databaseFilename, const QStringList& arguments, int& exitCode)
+{
+    const QString name = serverName(databaseFilename);
+    if (name.isEmpty()) {
+        return false;
+    }
+
+    QLocalSocket socket;
+    socket.connectToServer(name);
+    if (!socket.waitForConnected(ConnectTimeoutMSec)) {
+        return false;
+    }
+
+    QByteArray request;
+    QDataStream requestStream(&request, QIODevice::WriteOnly);
+    requestStream << ProtocolVersion << RunAction << arguments << QDir::currentPath();
+
+    // Another client may keep the agent busy, it does not run the command without a confirmation
+    QByteArray ready;
+    if (!sendRequest(&socket, request, ready, BusyTimeoutMSec) || ready != ReadyMessage) {
+        socket.abort();
+        return false;
+    }
+
+    QByteArray response;
+    if (!sendRequest(&socket, ConfirmMessage, response, CommandTimeoutMSec)) {
+        // The command may have been run already, so it is not repeated
+        Utils::STDERR << QObject::tr("Lost the connection to the agent.") << endl;
+        exitCode = EXIT_FAILURE;
+        return true;
+    }
+
+    bool handled = false;
+    QByteArray output;
+    QByteArray errorOutput;
+    QDataStream responseStream(response);
+    responseStream >> handled >> exitCode >> output >> errorOutput;
+    if (!handled) {
+        return false;
+    }
+
+    Utils::STDOUT.flush();
+    Utils::STDOUT.device()->write(output);
+    Utils::STDERR.flush();
+    Utils::STDERR.device()->write(errorOutput);
+    return true;
+}
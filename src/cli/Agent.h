@@ -0,0 +1,44 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_AGENT_H
+#define KEEPASSXC_AGENT_H
+
+#include "Command.h"
+
+/**
+ * Keeps a database unlocked in a background process and runs database commands for other
+ * keepassxc-cli invocations, so that the key derivation only has to be paid once.
+ *
+ * The agent listens on a local socket that is only accessible by the current user and
+ * exits after being idle for the configured timeout. Commands are forwarded to a running
+ * agent transparently by DatabaseCommand, they are opened directly if there is none or if
+ * it stays busy with another client for too long.
+ */
+class Agent : public Command
+{
+public:
+    Agent();
+    int execute(const QStringList& arguments) override;
+
+    static QString serverName(const QString& databaseFilename);
+    static bool forwardCommand(const QString& databaseFilename, const QStringList& arguments, int& exitCode);
+
+    static const QCommandLineOption TimeoutOption;
+};
+
+#endif // KEEPASSXC_AGENT_H
@@ -73,11 +73,21 @@ int Analyze::executeWithDatabase(QSharedPointer<Database> database, QSharedPoint
             return EXIT_FAILURE;
         }
 
-        out << QObject::tr("Evaluating database entries against HIBP file, this will take a while…") << endl;
+        out << QObject::tr("Evaluating database entries against HIBP file…") << endl;
 
-        if (!HibpOffline::report(database, hibpFile, findings, &error)) {
-            err << error << endl;
-            return EXIT_FAILURE;
+        if (!HibpOffline::mappedReport(database, hibpFile, findings, &error)) {
+            if (!error.isEmpty()) {
+                err << error << endl;
+                return EXIT_FAILURE;
+            }
+
+            // Not ordered by hash, scan the whole file instead
+            out << QObject::tr("HIBP file is not ordered by hash, this will take a while…") << endl;
+
+            if (!HibpOffline::report(database, hibpFile, findings, &error)) {
+                err << error << endl;
+                return EXIT_FAILURE;
+            }
         }
     }
 
@@ -166,3 +166,10 @@ int Clip::executeWithDatabase(QSharedPointer<Database> database, QSharedPointer<
 
     return EXIT_SUCCESS;
 }
+
+bool Clip::canRunInAgent(QSharedPointer<QCommandLineParser> parser) const
+{
+    Q_UNUSED(parser)
+    // Waiting for the clipboard timeout would keep the agent from serving anyone else
+    return false;
+}
@@ -26,6 +26,7 @@ public:
     Clip();
 
     int executeWithDatabase(QSharedPointer<Database> db, QSharedPointer<QCommandLineParser> parser) override;
+    bool canRunInAgent(QSharedPointer<QCommandLineParser> parser) const override;
 
     static const QCommandLineOption AttributeOption;
     static const QCommandLineOption TotpOption;
@@ -17,6 +17,7 @@
 
 #include "Add.h"
 #include "AddGroup.h"
+#include "Agent.h"
 #include "Analyze.h"
 #include "AttachmentExport.h"
 #include "AttachmentImport.h"
@@ -193,6 +194,7 @@ namespace Commands
             s_commands.insert(QStringLiteral("exit"), QSharedPointer<Command>(new Exit("exit")));
             s_commands.insert(QStringLiteral("quit"), QSharedPointer<Command>(new Exit("quit")));
         } else {
+            s_commands.insert(QStringLiteral("agent"), QSharedPointer<Command>(new Agent()));
             s_commands.insert(QStringLiteral("export"), QSharedPointer<Command>(new Export()));
             s_commands.insert(QStringLiteral("import"), QSharedPointer<Command>(new Import()));
         }
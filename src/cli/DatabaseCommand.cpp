@@ -17,6 +17,7 @@
 
 #include "DatabaseCommand.h"
 
+#include "Agent.h"
 #include "Utils.h"
 #include "config-keepassx.h"
 
@@ -52,6 +53,11 @@ int DatabaseCommand::execute(const QStringList& arguments)
         // database confuses these tests. Because of this, we leave it up to the interactive
         // mode implementation in the main command loop to update currentDatabase
         // (see keepassxc-cli.cpp).
+        int exitCode = EXIT_FAILURE;
+        if (canRunInAgent(parser) && Agent::forwardCommand(args.at(0), arguments, exitCode)) {
+            return exitCode;
+        }
+
         db = Utils::unlockDatabase(args.at(0),
                                    !parser->isSet(Command::NoPasswordOption),
                                    parser->value(Command::KeyFileOption),
@@ -68,3 +74,13 @@ int DatabaseCommand::execute(const QStringList& arguments)
 
     return executeWithDatabase(db, parser);
 }
+
+/**
+ * Whether a running agent may execute the command with its unlocked database. This is not
+ * the case for commands that prompt for input since the agent has no access to the terminal.
+ */
+bool DatabaseCommand::canRunInAgent(QSharedPointer<QCommandLineParser> parser) const
+{
+    Q_UNUSED(parser);
+    return true;
+}
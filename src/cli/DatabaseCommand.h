@@ -26,6 +26,7 @@ public:
     DatabaseCommand();
     int execute(const QStringList& arguments) override;
     virtual int executeWithDatabase(QSharedPointer<Database> db, QSharedPointer<QCommandLineParser> parser) = 0;
+    virtual bool canRunInAgent(QSharedPointer<QCommandLineParser> parser) const;
 };
 
 #endif // KEEPASSXC_DATABASECOMMAND_H
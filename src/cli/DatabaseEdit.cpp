@@ -172,3 +172,8 @@ QSharedPointer<CompositeKey> DatabaseEdit::getNewDatabaseKey(QSharedPointer<Data
 
     return newDatabaseKey;
 }
+
+bool DatabaseEdit::canRunInAgent(QSharedPointer<QCommandLineParser> parser) const
+{
+    return !parser->isSet(DatabaseCreate::SetPasswordOption);
+}
@@ -26,6 +26,7 @@ public:
     DatabaseEdit();
 
     int executeWithDatabase(QSharedPointer<Database> db, QSharedPointer<QCommandLineParser> parser) override;
+    bool canRunInAgent(QSharedPointer<QCommandLineParser> parser) const override;
 
     static const QCommandLineOption UnsetKeyFileOption;
     static const QCommandLineOption UnsetPasswordOption;
@@ -135,3 +135,8 @@ int Edit::executeWithDatabase(QSharedPointer<Database> database, QSharedPointer<
     out << QObject::tr("Successfully edited entry %1.").arg(entry->title()) << endl;
     return EXIT_SUCCESS;
 }
+
+bool Edit::canRunInAgent(QSharedPointer<QCommandLineParser> parser) const
+{
+    return !parser->isSet(Add::PasswordPromptOption);
+}
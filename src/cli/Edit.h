@@ -25,6 +25,7 @@ class Edit : public DatabaseCommand
 public:
     Edit();
     int executeWithDatabase(QSharedPointer<Database> db, QSharedPointer<QCommandLineParser> parser) override;
+    bool canRunInAgent(QSharedPointer<QCommandLineParser> parser) const override;
 
     static const QCommandLineOption TitleOption;
 };
@@ -22,6 +22,43 @@
 #include "format/CsvExporter.h"
 
 #include <QCommandLineParser>
+#include <QTextCodec>
+
+namespace
+{
+    /**
+     * Passes the UTF-8 written by the exporters on to a text stream, which encodes it for the console.
+     */
+    class TextStreamDevice : public QIODevice
+    {
+    public:
+        explicit TextStreamDevice(TextStream& stream)
+            : m_stream(stream)
+            , m_decoder(QTextCodec::codecForName("UTF-8")->makeDecoder())
+        {
+            open(QIODevice::WriteOnly);
+        }
+
+    protected:
+        qint64 readData(char* data, qint64 maxSize) override
+        {
+            Q_UNUSED(data)
+            Q_UNUSED(maxSize)
+            return -1;
+        }
+
+        qint64 writeData(const char* data, qint64 size) override
+        {
+            // The decoder keeps multi-byte sequences split between two writes
+            m_stream << m_decoder->toUnicode(data, static_cast<int>(size));
+            return m_stream.status() == QTextStream::Ok ? size : -1;
+        }
+
+    private:
+        TextStream& m_stream;
+        QScopedPointer<QTextDecoder> m_decoder;
+    };
+} // namespace
 
 const QCommandLineOption Export::FormatOption = QCommandLineOption(
     QStringList() << "f"
@@ -41,18 +78,23 @@ int Export::executeWithDatabase(QSharedPointer<Database> database, QSharedPointe
     TextStream out(Utils::STDOUT.device());
     auto& err = Utils::STDERR;
 
+    // The export is streamed through the console encoding instead of being built in memory first
+    TextStreamDevice textDevice(out);
+    QIODevice* device = &textDevice;
+
     QString format = parser->value(Export::FormatOption);
     if (format.isEmpty() || format.startsWith(QStringLiteral("xml"), Qt::CaseInsensitive)) {
-        QByteArray xmlData;
         QString errorMessage;
-        if (!database->extract(xmlData, &errorMessage)) {
+        if (!database->extract(device, &errorMessage)) {
             err << QObject::tr("Unable to export database to XML: %1").arg(errorMessage) << endl;
             return EXIT_FAILURE;
         }
-        out.write(xmlData.constData());
     } else if (format.startsWith(QStringLiteral("csv"), Qt::CaseInsensitive)) {
         CsvExporter csvExporter;
-        out << csvExporter.exportDatabase(database);
+        if (!csvExporter.exportDatabase(device, database)) {
+            err << QObject::tr("Unable to export database to CSV: %1").arg(csvExporter.errorString()) << endl;
+            return EXIT_FAILURE;
+        }
     } else {
         err << QObject::tr("Unsupported format %1").arg(format) << endl;
         return EXIT_FAILURE;
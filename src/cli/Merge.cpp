@@ -106,3 +106,9 @@ int Merge::executeWithDatabase(QSharedPointer<Database> database, QSharedPointer
 
     return EXIT_SUCCESS;
 }
+
+bool Merge::canRunInAgent(QSharedPointer<QCommandLineParser> parser) const
+{
+    // The database to merge from is unlocked with a prompt unless it uses the same credentials
+    return parser->isSet(Merge::SameCredentialsOption);
+}
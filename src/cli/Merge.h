@@ -26,6 +26,7 @@ public:
     Merge();
 
     int executeWithDatabase(QSharedPointer<Database> db, QSharedPointer<QCommandLineParser> parser) override;
+    bool canRunInAgent(QSharedPointer<QCommandLineParser> parser) const override;
 
     static const QCommandLineOption SameCredentialsOption;
     static const QCommandLineOption KeyFileFromOption;
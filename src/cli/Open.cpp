@@ -37,3 +37,10 @@ int Open::executeWithDatabase(QSharedPointer<Database> db, QSharedPointer<QComma
     currentDatabase = db;
     return EXIT_SUCCESS;
 }
+
+bool Open::canRunInAgent(QSharedPointer<QCommandLineParser> parser) const
+{
+    Q_UNUSED(parser)
+    // The interactive mode needs the database in this process
+    return false;
+}
@@ -26,6 +26,7 @@ public:
     Open();
     int execute(const QStringList& arguments) override;
     int executeWithDatabase(QSharedPointer<Database> db, QSharedPointer<QCommandLineParser> parser) override;
+    bool canRunInAgent(QSharedPointer<QCommandLineParser> parser) const override;
 };
 
 #endif // KEEPASSXC_OPEN_H
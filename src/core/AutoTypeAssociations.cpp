@@ -40,15 +40,28 @@ void AutoTypeAssociations::copyDataFrom(const AutoTypeAssociations* other)
 
     emit aboutToReset();
     m_associations = other->m_associations;
+    m_associationsSize = -1;
     emit reset();
     emitModified();
 }
 
+/**
+ * Share the storage of the associations if they are equal to the ones of other.
+ * Does not change the content, so no signals are emitted.
+ */
+void AutoTypeAssociations::shareDataFrom(const AutoTypeAssociations* other)
+{
+    if (m_associations == other->m_associations) {
+        m_associations = other->m_associations;
+    }
+}
+
 void AutoTypeAssociations::add(const AutoTypeAssociations::Association& association)
 {
     int index = m_associations.size();
     emit aboutToAdd(index);
     m_associations.append(association);
+    m_associationsSize = -1;
     emit added(index);
     emitModified();
 }
@@ -59,6 +72,7 @@ void AutoTypeAssociations::remove(int index)
 
     emit aboutToRemove(index);
     m_associations.removeAt(index);
+    m_associationsSize = -1;
     emit removed(index);
     emitModified();
 }
@@ -80,6 +94,7 @@ void AutoTypeAssociations::update(int index, const AutoTypeAssociations::Associa
 
     if (m_associations.at(index) != association) {
         m_associations[index] = association;
+        m_associationsSize = -1;
         emit dataChanged(index);
         emitModified();
     }
@@ -104,16 +119,20 @@ int AutoTypeAssociations::size() const
 
 int AutoTypeAssociations::associationsSize() const
 {
-    int size = 0;
-    for (const Association& association : m_associations) {
-        size += association.sequence.toUtf8().size() + association.window.toUtf8().size();
+    if (m_associationsSize < 0) {
+        int size = 0;
+        for (const Association& association : m_associations) {
+            size += association.sequence.toUtf8().size() + association.window.toUtf8().size();
+        }
+        m_associationsSize = size;
     }
-    return size;
+    return m_associationsSize;
 }
 
 void AutoTypeAssociations::clear()
 {
     m_associations.clear();
+    m_associationsSize = -1;
 }
 
 bool AutoTypeAssociations::operator==(const AutoTypeAssociations& other) const
@@ -36,6 +36,7 @@ public:
 
     explicit AutoTypeAssociations(QObject* parent = nullptr);
     void copyDataFrom(const AutoTypeAssociations* other);
+    void shareDataFrom(const AutoTypeAssociations* other);
     void add(const AutoTypeAssociations::Association& association);
     void remove(int index);
     void removeEmpty();
@@ -51,6 +52,8 @@ public:
 
 private:
     QList<AutoTypeAssociations::Association> m_associations;
+    // Computed on demand, reset whenever an association changes
+    mutable int m_associationsSize = -1;
 
 signals:
     void dataChanged(int index);
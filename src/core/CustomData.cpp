@@ -19,6 +19,7 @@
 
 #include "core/Clock.h"
 #include "core/Global.h"
+#include "core/Tools.h"
 
 const QString CustomData::LastModified = QStringLiteral("_LAST_MODIFIED");
 const QString CustomData::Created = QStringLiteral("_CREATED");
@@ -88,6 +89,7 @@ void CustomData::set(const QString& key, CustomDataItem item)
     }
     if (addAttribute || changeValue) {
         m_data.insert(key, item);
+        m_dataSize = -1;
         updateLastModified();
         emitModified();
     }
@@ -108,6 +110,7 @@ void CustomData::remove(const QString& key)
 
     if (m_data.contains(key)) {
         m_data.remove(key);
+        m_dataSize = -1;
         updateLastModified();
         emitModified();
     }
@@ -131,6 +134,7 @@ void CustomData::rename(const QString& oldKey, const QString& newKey)
     m_data.remove(oldKey);
     data.lastModified = Clock::currentDateTimeUtc();
     m_data.insert(newKey, data);
+    m_dataSize = -1;
 
     updateLastModified();
     emitModified();
@@ -146,12 +150,22 @@ void CustomData::copyDataFrom(const CustomData* other)
     emit aboutToBeReset();
 
     m_data = other->m_data;
+    m_dataSize = -1;
 
     updateLastModified();
     emit reset();
     emitModified();
 }
 
+/**
+ * Share the storage of all items that are equal to the ones of other.
+ * Does not change the content, so no signals are emitted.
+ */
+void CustomData::shareDataFrom(const CustomData* other)
+{
+    Tools::shareEqualValues(m_data, other->m_data);
+}
+
 QDateTime CustomData::lastModified() const
 {
     if (m_data.contains(LastModified)) {
@@ -177,6 +191,7 @@ void CustomData::updateLastModified(QDateTime lastModified)
 {
     if (m_data.isEmpty() || (m_data.size() == 1 && m_data.contains(LastModified))) {
         m_data.remove(LastModified);
+        m_dataSize = -1;
         return;
     }
 
@@ -184,6 +199,7 @@ void CustomData::updateLastModified(QDateTime lastModified)
         lastModified = Clock::currentDateTimeUtc();
     }
     m_data.insert(LastModified, {lastModified.toString(), QDateTime()});
+    m_dataSize = -1;
 }
 
 bool CustomData::isProtected(const QString& key) const
@@ -206,6 +222,7 @@ void CustomData::clear()
     emit aboutToBeReset();
 
     m_data.clear();
+    m_dataSize = -1;
 
     emit reset();
     emitModified();
@@ -223,6 +240,10 @@ int CustomData::size() const
 
 int CustomData::dataSize() const
 {
+    if (m_dataSize >= 0) {
+        return m_dataSize;
+    }
+
     int size = 0;
 
     QHashIterator<QString, CustomDataItem> i(m_data);
@@ -235,5 +256,6 @@ int CustomData::dataSize() const
         // actually retains the datetime in the KDBX file).
         size += i.key().toUtf8().size() + i.value().value.toUtf8().size();
     }
+    m_dataSize = size;
     return size;
 }
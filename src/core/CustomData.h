@@ -60,6 +60,7 @@ public:
     int size() const;
     int dataSize() const;
     void copyDataFrom(const CustomData* other);
+    void shareDataFrom(const CustomData* other);
     bool operator==(const CustomData& other) const;
     bool operator!=(const CustomData& other) const;
 
@@ -87,6 +88,8 @@ private slots:
 
 private:
     QHash<QString, CustomDataItem> m_data;
+    // Computed on demand, reset whenever an item changes
+    mutable int m_dataSize = -1;
 };
 
 #endif // KEEPASSXC_CUSTOMDATA_H
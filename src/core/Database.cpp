@@ -21,10 +21,14 @@
 #include "core/AsyncTask.h"
 #include "core/FileWatcher.h"
 #include "core/Group.h"
+#include "core/PasswordHealthCache.h"
+#include "core/ReferenceIndex.h"
+#include "core/SearchIndex.h"
 #include "format/KdbxXmlReader.h"
 #include "format/KeePass2Reader.h"
 #include "format/KeePass2Writer.h"
 
+#include <QBuffer>
 #include <QFileInfo>
 #include <QJsonObject>
 #include <QRegularExpression>
@@ -38,6 +42,8 @@ Database::Database()
     : m_metadata(new Metadata(this))
     , m_data()
     , m_rootGroup(nullptr)
+    , m_referenceIndex(new ReferenceIndex(this))
+    , m_passwordHealthCache(new PasswordHealthCache())
     , m_fileWatcher(new FileWatcher(this))
     , m_uuid(QUuid::createUuid())
 {
@@ -53,11 +59,12 @@ Database::Database()
     // other signals
     connect(m_metadata, &Metadata::modified, this, &Database::markAsModified);
     connect(this, &Database::databaseOpened, this, [this]() {
-        updateCommonUsernames();
-        updateTagList();
+        rebuildEntryStatistics();
+        emit tagListUpdated();
+        precomputePasswordHealth();
     });
-    connect(this, &Database::modified, this, [this] { updateTagList(); });
-    connect(this, &Database::databaseSaved, this, [this]() { updateCommonUsernames(); });
+    // Entry statistics are maintained incrementally, resync them in case changes went by unsignaled
+    connect(this, &Database::databaseSaved, this, &Database::updateTagList);
     connect(m_fileWatcher, &FileWatcher::fileChanged, this, &Database::databaseFileChanged);
 
     // static uuid map
@@ -163,6 +170,8 @@ bool Database::open(const QString& filePath, QSharedPointer<const CompositeKey>
     m_fileWatcher->start(canonicalFilePath(), 30, 1);
     setEmitModified(true);
 
+    precomputeNextKey();
+
     return true;
 }
 
@@ -283,6 +292,7 @@ bool Database::saveAs(const QString& filePath, SaveAction action, const QString&
             QFile::setPermissions(realFilePath, QFile::ReadUser | QFile::WriteUser);
         }
         m_fileWatcher->start(realFilePath, 30, 1);
+        precomputeNextKey();
     } else {
         // Saving failed, don't rewatch file since it does not represent our database
         markAsModified();
@@ -422,9 +432,19 @@ bool Database::writeDatabase(QIODevice* device, QString* error)
 }
 
 bool Database::extract(QByteArray& xmlOutput, QString* error)
+{
+    QBuffer buffer(&xmlOutput);
+    buffer.open(QIODevice::WriteOnly);
+    return extract(&buffer, error);
+}
+
+/**
+ * Write the database as unencrypted XML to the device, the XML is streamed as it is generated.
+ */
+bool Database::extract(QIODevice* device, QString* error)
 {
     KeePass2Writer writer;
-    writer.extractDatabase(this, xmlOutput);
+    writer.extractDatabase(this, device);
     if (writer.hasError()) {
         if (error) {
             *error = writer.errorString();
@@ -478,6 +498,7 @@ void Database::releaseData()
     s_uuidMap.remove(m_uuid);
     m_uuid = QUuid();
 
+    discardNextKey();
     m_data.clear();
     m_metadata->clear();
 
@@ -489,8 +510,8 @@ void Database::releaseData()
     m_fileWatcher->stop();
 
     m_deletedObjects.clear();
-    m_commonUsernames.clear();
-    m_tagList.clear();
+    m_passwordHealthCache->clear();
+    m_referenceIndex->invalidate();
 }
 
 /**
@@ -576,6 +597,46 @@ void Database::setRootGroup(Group* group)
 
     m_rootGroup = group;
     m_rootGroup->setParent(this);
+    m_referenceIndex->invalidate();
+    rebuildEntryStatistics();
+}
+
+SearchIndex* Database::searchIndex() const
+{
+    return m_searchIndex.data();
+}
+
+ReferenceIndex* Database::referenceIndex() const
+{
+    return m_referenceIndex.data();
+}
+
+PasswordHealthCache* Database::passwordHealthCache() const
+{
+    return m_passwordHealthCache.data();
+}
+
+/**
+ * Maintain a search index over all entries of this database which
+ * EntrySearcher uses to narrow down the entries it has to match.
+ *
+ * @param enabled true to build and maintain the index
+ */
+void Database::setSearchIndexEnabled(bool enabled)
+{
+    if (enabled == !m_searchIndex.isNull()) {
+        return;
+    }
+
+    if (!enabled) {
+        m_searchIndex.reset();
+        return;
+    }
+
+    m_searchIndex.reset(new SearchIndex());
+    for (auto entry : asConst(m_entryIndex)) {
+        m_searchIndex->addEntry(entry);
+    }
 }
 
 Metadata* Database::metadata()
@@ -679,6 +740,31 @@ void Database::addDeletedObject(const QUuid& uuid)
 
 const QStringList& Database::commonUsernames() const
 {
+    if (m_commonUsernamesDirty) {
+        // Sort username/frequency pairs by frequency and name
+        QList<QPair<QString, int>> sortedUsernames;
+        for (auto it = m_usernameCounts.constBegin(); it != m_usernameCounts.constEnd(); ++it) {
+            sortedUsernames.append({it.key(), it.value()});
+        }
+
+        const int count = m_commonUsernamesCount < 0 ? sortedUsernames.size()
+                                                     : std::min(m_commonUsernamesCount, sortedUsernames.size());
+        std::partial_sort(sortedUsernames.begin(),
+                          sortedUsernames.begin() + count,
+                          sortedUsernames.end(),
+                          [](const QPair<QString, int>& arg1, const QPair<QString, int>& arg2) {
+                              if (arg1.second == arg2.second) {
+                                  return arg1.first < arg2.first;
+                              }
+                              return arg1.second > arg2.second;
+                          });
+
+        m_commonUsernames.clear();
+        for (int i = 0; i < count; ++i) {
+            m_commonUsernames.append(sortedUsernames[i].first);
+        }
+        m_commonUsernamesDirty = false;
+    }
     return m_commonUsernames;
 }
 
@@ -689,32 +775,123 @@ const QStringList& Database::tagList() const
 
 void Database::updateCommonUsernames(int topN)
 {
-    m_commonUsernames.clear();
-    m_commonUsernames.append(rootGroup()->usernamesRecursive(topN));
+    m_commonUsernamesCount = topN;
+    m_commonUsernamesDirty = true;
 }
 
+/**
+ * Rescan all entries for tags and usernames. Both are normally kept up to date
+ * incrementally as entries change, are added or are removed.
+ */
 void Database::updateTagList()
 {
-    m_tagList.clear();
-    if (!m_rootGroup) {
+    if (rebuildEntryStatistics()) {
         emit tagListUpdated();
-        return;
     }
+}
 
-    // Search groups recursively looking for tags
-    // Use a set to prevent adding duplicates
-    QSet<QString> tagSet;
-    for (auto entry : m_rootGroup->entriesRecursive()) {
-        if (!entry->isRecycled()) {
-            for (auto tag : entry->tagList()) {
-                tagSet.insert(tag);
+void Database::updateEntryStatistics(const Entry* entry)
+{
+    EntryStatistics statistics;
+
+    // Entries outside of the current root group, such as in a replaced root group, are not counted
+    const Group* recycleBin = m_metadata->recycleBin();
+    bool recycled = false;
+    for (const Group* group = entry->group(); group; group = group->parentGroup()) {
+        recycled = recycled || (recycleBin && group == recycleBin);
+        if (group == m_rootGroup) {
+            // Don't count tags in the recycle bin
+            if (!recycled) {
+                statistics.tags = entry->tagList();
+            }
+            if (!entry->isAttributeReference(EntryAttributes::UserNameKey)) {
+                statistics.username = entry->username();
+            }
+            break;
+        }
+    }
+
+    if (setEntryStatistics(entry, statistics)) {
+        emit tagListUpdated();
+    }
+}
+
+/**
+ * Replace the tags and username counted for an entry.
+ *
+ * @return true if the set of tags changed
+ */
+bool Database::setEntryStatistics(const Entry* entry, const EntryStatistics& statistics)
+{
+    const auto previous = m_entryStatistics.take(entry);
+    if (!statistics.tags.isEmpty() || !statistics.username.isEmpty()) {
+        m_entryStatistics.insert(entry, statistics);
+    }
+
+    bool tagsChanged = false;
+    if (previous.tags != statistics.tags) {
+        // Count the new tags first so tags kept by the entry never drop to zero
+        for (const auto& tag : statistics.tags) {
+            tagsChanged |= (++m_tagCounts[tag] == 1);
+        }
+        for (const auto& tag : previous.tags) {
+            auto it = m_tagCounts.find(tag);
+            if (--it.value() == 0) {
+                m_tagCounts.erase(it);
+                tagsChanged = true;
             }
         }
     }
 
-    m_tagList = tagSet.toList();
-    m_tagList.sort();
-    emit tagListUpdated();
+    if (previous.username != statistics.username) {
+        if (!previous.username.isEmpty()) {
+            auto it = m_usernameCounts.find(previous.username);
+            if (--it.value() == 0) {
+                m_usernameCounts.erase(it);
+            }
+        }
+        if (!statistics.username.isEmpty()) {
+            ++m_usernameCounts[statistics.username];
+        }
+        m_commonUsernamesDirty = true;
+    }
+
+    if (tagsChanged) {
+        m_tagList = m_tagCounts.keys();
+        m_tagList.sort();
+    }
+    return tagsChanged;
+}
+
+/**
+ * Recount the tags and usernames of all entries in the root group.
+ *
+ * @return true if the set of tags changed
+ */
+bool Database::rebuildEntryStatistics()
+{
+    const auto previousTags = m_tagList;
+
+    m_entryStatistics.clear();
+    m_tagCounts.clear();
+    m_usernameCounts.clear();
+    m_tagList.clear();
+    m_commonUsernamesDirty = true;
+
+    if (m_rootGroup) {
+        for (const auto* entry : m_rootGroup->entriesRecursive()) {
+            EntryStatistics statistics;
+            if (!entry->isRecycled()) {
+                statistics.tags = entry->tagList();
+            }
+            if (!entry->isAttributeReference(EntryAttributes::UserNameKey)) {
+                statistics.username = entry->username();
+            }
+            setEntryStatistics(entry, statistics);
+        }
+    }
+
+    return m_tagList != previousTags;
 }
 
 void Database::removeTag(const QString& tag)
@@ -797,14 +974,28 @@ bool Database::setKey(const QSharedPointer<const CompositeKey>& key,
     m_keyError.clear();
 
     if (!key) {
+        discardNextKey();
         m_data.key.reset();
         m_data.transformedDatabaseKey.reset(new PasswordKey());
         return true;
     }
 
+    QByteArray transformedDatabaseKey;
+    bool precomputed = false;
+
     if (updateTransformSalt) {
-        m_data.kdf->randomizeSeed();
+        // Use the key transformed in the background for a fresh salt if there is one
+        precomputed = transformKey && takeNextKey(key, transformedDatabaseKey);
+        if (!precomputed) {
+            m_data.kdf->randomizeSeed();
+        }
         Q_ASSERT(!m_data.kdf->seed().isEmpty());
+    } else {
+        if (key != m_data.key) {
+            discardNextKey();
+        }
+        // Reuse the key of the database this one is reloaded from if the KDF header matches
+        precomputed = transformKey && takeCachedKey(key, transformedDatabaseKey);
     }
 
     PasswordKey oldTransformedDatabaseKey;
@@ -812,14 +1003,13 @@ bool Database::setKey(const QSharedPointer<const CompositeKey>& key,
         oldTransformedDatabaseKey.setRawKey(m_data.transformedDatabaseKey->rawKey());
     }
 
-    QByteArray transformedDatabaseKey;
-
     if (!transformKey) {
         transformedDatabaseKey = QByteArray(oldTransformedDatabaseKey.rawKey());
-    } else if (!key->transform(*m_data.kdf, transformedDatabaseKey, &m_keyError)) {
+    } else if (!precomputed && !key->transform(*m_data.kdf, transformedDatabaseKey, &m_keyError)) {
         return false;
     }
 
+    bool keyChanged = m_data.key && m_data.key != key;
     m_data.key = key;
     if (!transformedDatabaseKey.isEmpty()) {
         m_data.transformedDatabaseKey->setRawKey(transformedDatabaseKey);
@@ -832,6 +1022,11 @@ bool Database::setKey(const QSharedPointer<const CompositeKey>& key,
         markAsModified();
     }
 
+    // The first key of a database is pre-computed once its file is open
+    if (keyChanged) {
+        precomputeNextKey();
+    }
+
     return true;
 }
 
@@ -840,6 +1035,208 @@ QString Database::keyError()
     return m_keyError;
 }
 
+bool Database::isKeyPrecomputationEnabled() const
+{
+    return m_keyPrecomputation;
+}
+
+/**
+ * Speculatively transform the key for the next transform seed in the background
+ * after every unlock and save. The next save consumes the pre-computed key instead
+ * of running the KDF, unless the key or KDF settings changed in the meantime.
+ *
+ * Keys with challenge-response components are never pre-computed since that would
+ * require user interaction.
+ *
+ * @param enabled true to enable key pre-computation
+ */
+void Database::setKeyPrecomputationEnabled(bool enabled)
+{
+    if (m_keyPrecomputation == enabled) {
+        return;
+    }
+
+    m_keyPrecomputation = enabled;
+    if (enabled) {
+        precomputeNextKey();
+    } else {
+        discardNextKey();
+    }
+}
+
+/**
+ * Offer the current transformed key of another database for reuse when this database
+ * is read from a file. If the composite key, KDF and KDF parameters including the seed
+ * in the file header match those of the source database, reading skips the KDF.
+ *
+ * The cached key is kept in protected memory and is consumed by the next key change.
+ *
+ * @param source database whose transformed key may be reused
+ */
+void Database::setTransformedKeyCache(const Database* source)
+{
+    m_data.cachedKey.reset();
+
+    if (!source || !source->isInitialized() || !source->m_data.kdf
+        || source->m_data.transformedDatabaseKey->rawKey().isEmpty()) {
+        return;
+    }
+
+    auto cachedKey = QSharedPointer<PrecomputedKey>::create();
+    cachedKey->key = source->m_data.key;
+    cachedKey->kdf = source->m_data.kdf->clone();
+    cachedKey->transformedDatabaseKey.setRawKey(source->m_data.transformedDatabaseKey->rawKey());
+    m_data.cachedKey = cachedKey;
+}
+
+/**
+ * Estimate the strength of all passwords on the global thread pool after every
+ * unlock, so that password health is readily available to the entry view, the
+ * health check and the statistics.
+ *
+ * @param enabled true to enable password health pre-computation
+ */
+void Database::setPasswordHealthPrecomputationEnabled(bool enabled)
+{
+    if (m_passwordHealthPrecomputation == enabled) {
+        return;
+    }
+
+    m_passwordHealthPrecomputation = enabled;
+    if (enabled) {
+        precomputePasswordHealth();
+    }
+}
+
+void Database::precomputePasswordHealth()
+{
+    if (!m_passwordHealthPrecomputation || !m_rootGroup) {
+        return;
+    }
+
+    // Placeholders are resolved here since entries must not be accessed from the thread pool
+    QSet<QString> passwords;
+    for (const auto* entry : m_rootGroup->entriesRecursive()) {
+        const auto password = entry->password();
+        if (!password.isEmpty()) {
+            passwords.insert(password);
+            passwords.insert(entry->resolvePlaceholder(password));
+        }
+    }
+    m_passwordHealthCache->precompute(passwords.values());
+}
+
+void Database::precomputeNextKey()
+{
+    discardNextKey();
+
+    if (!m_keyPrecomputation || !isInitialized() || !m_data.kdf
+        || !m_data.key->challengeResponseKeys().isEmpty()) {
+        return;
+    }
+
+    auto nextKey = QSharedPointer<PrecomputedKey>::create();
+    nextKey->key = m_data.key;
+    nextKey->kdf = m_data.kdf->clone();
+    nextKey->kdf->randomizeSeed();
+    // Without challenge-response components the raw key does not depend on the seed
+    nextKey->rawKey.setRawKey(m_data.key->rawKey());
+
+    // The worker only touches the raw key, the KDF and the result, never the composite key
+    m_data.nextKey = nextKey;
+    m_data.nextKeyFuture = QtConcurrent::run([nextKey] {
+        QByteArray transformedKey;
+        bool ok = !nextKey->cancelled.loadAcquire()
+                  && nextKey->kdf->transform(nextKey->rawKey.rawKey(), transformedKey);
+        nextKey->rawKey.setRawKey({});
+        if (!ok || nextKey->cancelled.loadAcquire()) {
+            return false;
+        }
+        nextKey->transformedDatabaseKey.setRawKey(transformedKey);
+        return true;
+    });
+}
+
+void Database::discardNextKey()
+{
+    if (m_data.nextKey) {
+        // The KDF cannot be interrupted, but a computation still in flight skips or drops its
+        // result and the composite key is released right away
+        m_data.nextKey->cancelled.storeRelease(1);
+        m_data.nextKey->key.reset();
+    }
+    m_data.nextKey.reset();
+    m_data.nextKeyFuture = {};
+}
+
+/**
+ * Take the pre-computed transformed key if it matches the given key and the current KDF
+ * settings, waiting for the computation to finish if necessary. On success the KDF
+ * seed is updated to the one the key was transformed with.
+ *
+ * @param key composite key that is about to be transformed
+ * @param transformedKey pre-computed transformed key
+ * @return true if a matching pre-computed key was available
+ */
+bool Database::takeNextKey(const QSharedPointer<const CompositeKey>& key, QByteArray& transformedKey)
+{
+    if (!m_data.nextKey || m_data.nextKey->key != key || !m_data.kdf) {
+        discardNextKey();
+        return false;
+    }
+
+    // KDF parameters other than the seed must not have changed since the computation was started
+    auto expectedKdf = m_data.kdf->clone();
+    expectedKdf->setSeed(m_data.nextKey->kdf->seed());
+    if (expectedKdf->writeParameters() != m_data.nextKey->kdf->writeParameters()) {
+        discardNextKey();
+        return false;
+    }
+
+    auto nextKey = m_data.nextKey;
+    auto future = m_data.nextKeyFuture;
+    m_data.nextKey.reset();
+    m_data.nextKeyFuture = {};
+
+    if (!future.result()) {
+        return false;
+    }
+
+    transformedKey = nextKey->transformedDatabaseKey.rawKey();
+    if (transformedKey.isEmpty()) {
+        return false;
+    }
+
+    m_data.kdf->setSeed(nextKey->kdf->seed());
+    return true;
+}
+
+/**
+ * Take the cached transformed key set by setTransformedKeyCache() if it was transformed
+ * from the given key with the current KDF and KDF parameters.
+ *
+ * @param key composite key that is about to be transformed
+ * @param transformedKey cached transformed key
+ * @return true if a matching cached key was available
+ */
+bool Database::takeCachedKey(const QSharedPointer<const CompositeKey>& key, QByteArray& transformedKey)
+{
+    auto cachedKey = m_data.cachedKey;
+    m_data.cachedKey.reset();
+
+    if (!cachedKey || cachedKey->key != key || !m_data.kdf) {
+        return false;
+    }
+
+    if (cachedKey->kdf->uuid() != m_data.kdf->uuid()
+        || cachedKey->kdf->writeParameters() != m_data.kdf->writeParameters()) {
+        return false;
+    }
+
+    transformedKey = cachedKey->transformedDatabaseKey.rawKey();
+    return !transformedKey.isEmpty();
+}
+
 QVariantMap& Database::publicCustomData()
 {
     return m_data.publicCustomData;
@@ -868,6 +1265,40 @@ void Database::createRecycleBin()
     m_metadata->setRecycleBin(recycleBin);
 }
 
+void Database::indexEntry(Entry* entry)
+{
+    m_entryIndex.insert(entry->uuid(), entry);
+    m_referenceIndex->invalidate();
+    if (m_searchIndex) {
+        m_searchIndex->addEntry(entry);
+    }
+    updateEntryStatistics(entry);
+    emit entryAdded(entry);
+}
+
+void Database::unindexEntry(Entry* entry)
+{
+    m_entryIndex.remove(entry->uuid(), entry);
+    m_referenceIndex->invalidate();
+    if (m_searchIndex) {
+        m_searchIndex->removeEntry(entry);
+    }
+    if (setEntryStatistics(entry, {})) {
+        emit tagListUpdated();
+    }
+    emit entryRemoved(entry);
+}
+
+void Database::indexGroup(Group* group)
+{
+    m_groupIndex.insert(group->uuid(), group);
+}
+
+void Database::unindexGroup(Group* group)
+{
+    m_groupIndex.remove(group->uuid(), group);
+}
+
 void Database::recycleEntry(Entry* entry)
 {
     if (m_metadata->recycleBinEnabled()) {
@@ -921,6 +1352,7 @@ bool Database::hasNonDataChanges() const
 void Database::markAsModified()
 {
     m_modified = true;
+    m_referenceIndex->invalidate();
     if (modifiedSignalEnabled() && !m_modifiedTimer.isActive()) {
         // Small time delay prevents numerous consecutive saves due to repeated signals
         startModifiedTimer();
@@ -941,6 +1373,8 @@ void Database::markAsClean()
 void Database::markNonDataChange()
 {
     m_hasNonDataChange = true;
+    // Entry order affects which entry a reference resolves to
+    m_referenceIndex->invalidate();
     emit databaseNonDataChanged();
 }
 
@@ -965,6 +1399,7 @@ QSharedPointer<Kdf> Database::kdf() const
 
 void Database::setKdf(QSharedPointer<Kdf> kdf)
 {
+    discardNextKey();
     m_data.kdf = std::move(kdf);
     setFormatVersion(KeePass2Writer::kdbxVersionRequired(this, true, m_data.kdf.isNull()));
 }
@@ -19,7 +19,9 @@
 #ifndef KEEPASSX_DATABASE_H
 #define KEEPASSX_DATABASE_H
 
+#include <QAtomicInt>
 #include <QDateTime>
+#include <QFuture>
 #include <QHash>
 #include <QMutex>
 #include <QPointer>
@@ -37,6 +39,9 @@ enum class EntryReferenceType;
 class FileWatcher;
 class Group;
 class Metadata;
+class PasswordHealthCache;
+class ReferenceIndex;
+class SearchIndex;
 class QIODevice;
 
 struct DeletedObject
@@ -89,6 +94,7 @@ public:
                 const QString& backupFilePath = QString(),
                 QString* error = nullptr);
     bool extract(QByteArray&, QString* error = nullptr);
+    bool extract(QIODevice* device, QString* error = nullptr);
     bool import(const QString& xmlExportPath, QString* error = nullptr);
 
     quint32 formatVersion() const;
@@ -113,6 +119,10 @@ public:
     Group* rootGroup();
     const Group* rootGroup() const;
     void setRootGroup(Group* group);
+    SearchIndex* searchIndex() const;
+    ReferenceIndex* referenceIndex() const;
+    PasswordHealthCache* passwordHealthCache() const;
+    void setSearchIndexEnabled(bool enabled);
     QVariantMap& publicCustomData();
     const QVariantMap& publicCustomData() const;
     void setPublicCustomData(const QVariantMap& customData);
@@ -149,6 +159,10 @@ public:
     void setKdf(QSharedPointer<Kdf> kdf);
     bool changeKdf(const QSharedPointer<Kdf>& kdf);
     QByteArray transformedDatabaseKey() const;
+    bool isKeyPrecomputationEnabled() const;
+    void setKeyPrecomputationEnabled(bool enabled);
+    void setTransformedKeyCache(const Database* source);
+    void setPasswordHealthPrecomputationEnabled(bool enabled);
 
     static Database* databaseByUuid(const QUuid& uuid);
 
@@ -174,8 +188,29 @@ signals:
     void databaseFileChanged();
     void databaseNonDataChanged();
     void tagListUpdated();
+    // Emitted when an entry is attached to or detached from a group of this database,
+    // including when it moves between groups
+    void entryAdded(Entry* entry);
+    void entryRemoved(Entry* entry);
 
 private:
+    struct PrecomputedKey
+    {
+        QSharedPointer<const CompositeKey> key;
+        QSharedPointer<Kdf> kdf;
+        PasswordKey transformedDatabaseKey;
+        // Input of a background transformation, which must not keep the composite key alive
+        PasswordKey rawKey;
+        QAtomicInt cancelled;
+    };
+
+    // Tags and username an entry contributes to the tag list and common usernames
+    struct EntryStatistics
+    {
+        QStringList tags;
+        QString username;
+    };
+
     struct DatabaseData
     {
         quint32 formatVersion = 0;
@@ -190,6 +225,10 @@ private:
         QSharedPointer<const CompositeKey> key;
         QSharedPointer<Kdf> kdf = QSharedPointer<AesKdf>::create(true);
 
+        QSharedPointer<PrecomputedKey> nextKey;
+        QFuture<bool> nextKeyFuture;
+        QSharedPointer<PrecomputedKey> cachedKey;
+
         QVariantMap publicCustomData;
 
         DatabaseData()
@@ -211,12 +250,33 @@ private:
             key.reset();
             kdf.reset();
 
+            nextKey.reset();
+            nextKeyFuture = {};
+            cachedKey.reset();
+
             publicCustomData.clear();
         }
     };
 
     void createRecycleBin();
 
+    // UUID index of all entries and groups attached to this database, maintained by Group and Entry
+    friend class Entry;
+    friend class Group;
+    void indexEntry(Entry* entry);
+    void unindexEntry(Entry* entry);
+    void indexGroup(Group* group);
+    void unindexGroup(Group* group);
+    void updateEntryStatistics(const Entry* entry);
+    bool setEntryStatistics(const Entry* entry, const EntryStatistics& statistics);
+    bool rebuildEntryStatistics();
+
+    void precomputeNextKey();
+    void precomputePasswordHealth();
+    void discardNextKey();
+    bool takeNextKey(const QSharedPointer<const CompositeKey>& key, QByteArray& transformedKey);
+    bool takeCachedKey(const QSharedPointer<const CompositeKey>& key, QByteArray& transformedKey);
+
     void startModifiedTimer();
     void stopModifiedTimer();
 
@@ -224,14 +284,26 @@ private:
     DatabaseData m_data;
     QPointer<Group> m_rootGroup;
     QList<DeletedObject> m_deletedObjects;
+    QMultiHash<QUuid, Entry*> m_entryIndex;
+    QMultiHash<QUuid, Group*> m_groupIndex;
+    QScopedPointer<SearchIndex> m_searchIndex;
+    QScopedPointer<ReferenceIndex> m_referenceIndex;
+    QScopedPointer<PasswordHealthCache> m_passwordHealthCache;
     QTimer m_modifiedTimer;
     QMutex m_saveMutex;
     QPointer<FileWatcher> m_fileWatcher;
     bool m_modified = false;
     bool m_hasNonDataChange = false;
+    bool m_keyPrecomputation = false;
+    bool m_passwordHealthPrecomputation = false;
     QString m_keyError;
 
-    QStringList m_commonUsernames;
+    QHash<const Entry*, EntryStatistics> m_entryStatistics;
+    QHash<QString, int> m_tagCounts;
+    QHash<QString, int> m_usernameCounts;
+    mutable QStringList m_commonUsernames;
+    mutable bool m_commonUsernamesDirty = false;
+    int m_commonUsernamesCount = 10;
     QStringList m_tagList;
 
     QUuid m_uuid;
@@ -0,0 +1,303 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DatabaseDiff.h"
+
+#include "core/Clock.h"
+#include "core/Database.h"
+#include "core/Group.h"
+#include "core/Metadata.h"
+#include "crypto/kdf/Kdf.h"
+
+namespace
+{
+    // Times in memory carry milliseconds that are lost when the database is written
+    bool modifiedAtDifferentTime(const TimeInfo& sourceTimeInfo, const TimeInfo& targetTimeInfo)
+    {
+        return Clock::serialized(sourceTimeInfo.lastModificationTime())
+               != Clock::serialized(targetTimeInfo.lastModificationTime());
+    }
+
+    bool historyDiffers(const Entry* sourceEntry, const Entry* targetEntry)
+    {
+        const auto& sourceHistory = sourceEntry->historyItems();
+        const auto& targetHistory = targetEntry->historyItems();
+        if (sourceHistory.size() != targetHistory.size()) {
+            return true;
+        }
+        for (int i = 0; i < sourceHistory.size(); ++i) {
+            if (modifiedAtDifferentTime(sourceHistory[i]->timeInfo(), targetHistory[i]->timeInfo())) {
+                return true;
+            }
+        }
+        return false;
+    }
+} // namespace
+
+DatabaseDiff::DatabaseDiff(const Database* sourceDb, Database* targetDb)
+    : m_sourceDb(sourceDb)
+    , m_targetDb(targetDb)
+    , m_changes(0)
+{
+}
+
+/**
+ * Apply the difference between the source and the target database to the target.
+ *
+ * The target ends up with the modification state of the source, a target that was
+ * clean before is clean afterwards if the source was freshly read from a file.
+ *
+ * @return false if the databases are too different to be reconciled in place,
+ *         in that case the target is left untouched
+ */
+bool DatabaseDiff::apply()
+{
+    m_changes = 0;
+    if (!canApply()) {
+        return false;
+    }
+
+    m_sourceEntries.clear();
+    m_sourceGroups.clear();
+    for (const Entry* entry : m_sourceDb->rootGroup()->entriesRecursive()) {
+        m_sourceEntries.insert(entry->uuid());
+    }
+    for (const Group* group : m_sourceDb->rootGroup()->groupsRecursive(true)) {
+        m_sourceGroups.insert(group->uuid());
+    }
+
+    // Icons go first so that added items never reference a missing icon
+    applyCustomIcons();
+
+    m_targetDb->setCipher(m_sourceDb->cipher());
+    m_targetDb->setCompressionAlgorithm(m_sourceDb->compressionAlgorithm());
+    m_targetDb->setFormatVersion(m_sourceDb->formatVersion());
+    m_targetDb->setPublicCustomData(m_sourceDb->publicCustomData());
+
+    applyGroup(m_sourceDb->rootGroup(), m_targetDb->rootGroup());
+    removeStaleItems();
+    // Moving and removing items touches the time info of their groups, restore it last
+    applyGroupData(m_sourceDb->rootGroup());
+    applyMetadata();
+
+    m_targetDb->setDeletedObjects(m_sourceDb->deletedObjects());
+
+    if (m_sourceDb->isModified()) {
+        m_targetDb->markAsModified();
+    } else {
+        m_targetDb->markAsClean();
+    }
+
+    return true;
+}
+
+/**
+ * Number of groups and entries that were added, removed, moved or updated by apply().
+ */
+int DatabaseDiff::changes() const
+{
+    return m_changes;
+}
+
+bool DatabaseDiff::canApply() const
+{
+    if (!m_sourceDb || !m_targetDb || !m_sourceDb->rootGroup() || !m_targetDb->rootGroup()) {
+        return false;
+    }
+    if (m_sourceDb->rootGroup()->uuid() != m_targetDb->rootGroup()->uuid()) {
+        return false;
+    }
+    if (m_sourceDb->key() != m_targetDb->key()) {
+        return false;
+    }
+
+    // The target keeps its transformed key, so only the KDF seed may differ
+    auto sourceKdf = m_sourceDb->kdf();
+    auto targetKdf = m_targetDb->kdf();
+    if (!sourceKdf || !targetKdf || sourceKdf->uuid() != targetKdf->uuid()) {
+        return false;
+    }
+    auto expectedKdf = targetKdf->clone();
+    expectedKdf->setSeed(sourceKdf->seed());
+    return expectedKdf->writeParameters() == sourceKdf->writeParameters();
+}
+
+void DatabaseDiff::applyCustomIcons()
+{
+    auto* sourceMetadata = m_sourceDb->metadata();
+    auto* targetMetadata = m_targetDb->metadata();
+
+    for (const QUuid& uuid : targetMetadata->customIconsOrder()) {
+        if (!sourceMetadata->hasCustomIcon(uuid)) {
+            targetMetadata->removeCustomIcon(uuid);
+        }
+    }
+
+    for (const QUuid& uuid : sourceMetadata->customIconsOrder()) {
+        const auto& icon = sourceMetadata->customIcon(uuid);
+        if (targetMetadata->hasCustomIcon(uuid)) {
+            const auto& targetIcon = targetMetadata->customIcon(uuid);
+            if (targetIcon == icon && targetIcon.name == icon.name && targetIcon.lastModified == icon.lastModified) {
+                continue;
+            }
+            targetMetadata->removeCustomIcon(uuid);
+        }
+        targetMetadata->addCustomIcon(uuid, icon);
+    }
+}
+
+/**
+ * Place the children and entries of the source group under the target group in the
+ * same order, adding and moving items as needed, and update changed entries.
+ */
+void DatabaseDiff::applyGroup(const Group* sourceGroup, Group* targetGroup)
+{
+    const auto& sourceChildren = sourceGroup->children();
+    for (int i = 0; i < sourceChildren.size(); ++i) {
+        const Group* sourceChild = sourceChildren[i];
+        Group* targetChild = m_targetDb->rootGroup()->findGroupByUuid(sourceChild->uuid());
+        if (!targetChild) {
+            targetChild = sourceChild->clone(Entry::CloneNoFlags, Group::CloneNoFlags);
+            targetChild->setUpdateTimeinfo(false);
+            targetChild->setParent(targetGroup, i, false);
+            ++m_changes;
+        } else if (targetChild->parentGroup() != targetGroup || targetGroup->children().indexOf(targetChild) != i) {
+            targetChild->setUpdateTimeinfo(false);
+            targetChild->setParent(targetGroup, i, false);
+            ++m_changes;
+        }
+        applyGroup(sourceChild, targetChild);
+    }
+
+    const auto& sourceEntries = sourceGroup->entries();
+    for (int i = 0; i < sourceEntries.size(); ++i) {
+        applyEntry(sourceEntries[i], targetGroup, i);
+    }
+}
+
+void DatabaseDiff::applyEntry(const Entry* sourceEntry, Group* targetGroup, int index)
+{
+    Entry* targetEntry = m_targetDb->rootGroup()->findEntryByUuid(sourceEntry->uuid());
+    if (!targetEntry) {
+        targetEntry = sourceEntry->clone(Entry::CloneIncludeHistory);
+        targetEntry->setUpdateTimeinfo(false);
+        targetEntry->setGroup(targetGroup, false);
+        targetEntry->setUpdateTimeinfo(true);
+        ++m_changes;
+    } else {
+        const bool moved = targetEntry->group() != targetGroup;
+        const bool modified = modifiedAtDifferentTime(sourceEntry->timeInfo(), targetEntry->timeInfo());
+        const bool historyChanged = historyDiffers(sourceEntry, targetEntry);
+
+        if (moved || modified || historyChanged) {
+            targetEntry->setUpdateTimeinfo(false);
+            if (moved) {
+                targetEntry->setGroup(targetGroup, false);
+            }
+            if (historyChanged) {
+                targetEntry->removeHistoryItems(targetEntry->historyItems());
+                for (const Entry* historyItem : sourceEntry->historyItems()) {
+                    targetEntry->addHistoryItem(historyItem->clone(Entry::CloneNoFlags));
+                }
+            }
+            // Also restores the time info and re-enables time info updates
+            targetEntry->copyDataFrom(sourceEntry);
+            // copyDataFrom() is silent about the fields outside of the attributes, such as tags and icon,
+            // let views and the tag list pick them up like any other edit
+            emit targetEntry->modified();
+            emit targetEntry->entryDataChanged(targetEntry);
+            ++m_changes;
+        }
+    }
+
+    // Entries before the index are already in place, so the entry can only be further down
+    int row = targetGroup->entries().indexOf(targetEntry);
+    while (row > index) {
+        targetGroup->moveEntryUp(targetEntry);
+        --row;
+    }
+}
+
+void DatabaseDiff::applyGroupData(const Group* sourceGroup)
+{
+    Group* targetGroup = m_targetDb->rootGroup()->findGroupByUuid(sourceGroup->uuid());
+    Q_ASSERT(targetGroup);
+    if (!targetGroup) {
+        return;
+    }
+
+    if (modifiedAtDifferentTime(sourceGroup->timeInfo(), targetGroup->timeInfo())) {
+        ++m_changes;
+    }
+    targetGroup->setUpdateTimeinfo(false);
+    targetGroup->copyDataFrom(sourceGroup);
+    targetGroup->setUpdateTimeinfo(true);
+
+    for (const Group* sourceChild : sourceGroup->children()) {
+        applyGroupData(sourceChild);
+    }
+}
+
+void DatabaseDiff::applyMetadata()
+{
+    auto* sourceMetadata = m_sourceDb->metadata();
+    auto* targetMetadata = m_targetDb->metadata();
+    auto* targetRoot = m_targetDb->rootGroup();
+
+    auto targetGroup = [targetRoot](const Group* sourceGroup) -> Group* {
+        return sourceGroup ? targetRoot->findGroupByUuid(sourceGroup->uuid()) : nullptr;
+    };
+
+    targetMetadata->setUpdateDatetime(false);
+    targetMetadata->copyAttributesFrom(sourceMetadata);
+    targetMetadata->customData()->copyDataFrom(sourceMetadata->customData());
+    targetMetadata->setRecycleBin(targetGroup(sourceMetadata->recycleBin()));
+    targetMetadata->setRecycleBinChanged(sourceMetadata->recycleBinChanged());
+    targetMetadata->setEntryTemplatesGroup(targetGroup(sourceMetadata->entryTemplatesGroup()));
+    targetMetadata->setEntryTemplatesGroupChanged(sourceMetadata->entryTemplatesGroupChanged());
+    targetMetadata->setLastSelectedGroup(targetGroup(sourceMetadata->lastSelectedGroup()));
+    targetMetadata->setLastTopVisibleGroup(targetGroup(sourceMetadata->lastTopVisibleGroup()));
+    targetMetadata->setDatabaseKeyChanged(sourceMetadata->databaseKeyChanged());
+    targetMetadata->setSettingsChanged(sourceMetadata->settingsChanged());
+    targetMetadata->setUpdateDatetime(true);
+}
+
+/**
+ * Remove all entries and groups of the target that do not exist in the source. Every
+ * item that still exists has been moved to its place by applyGroup() at this point.
+ */
+void DatabaseDiff::removeStaleItems()
+{
+    for (Entry* entry : m_targetDb->rootGroup()->entriesRecursive()) {
+        if (!m_sourceEntries.contains(entry->uuid())) {
+            delete entry;
+            ++m_changes;
+        }
+    }
+
+    // Deleting a group deletes its subgroups, so only delete the topmost stale groups
+    QList<Group*> staleGroups;
+    for (Group* group : m_targetDb->rootGroup()->groupsRecursive(false)) {
+        if (!m_sourceGroups.contains(group->uuid()) && m_sourceGroups.contains(group->parentGroup()->uuid())) {
+            staleGroups.append(group);
+        }
+    }
+    for (Group* group : staleGroups) {
+        m_changes += group->groupsRecursive(true).size();
+        delete group;
+    }
+}
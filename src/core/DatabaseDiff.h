@@ -0,0 +1,61 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_DATABASEDIFF_H
+#define KEEPASSXC_DATABASEDIFF_H
+
+#include <QSet>
+#include <QUuid>
+
+class Database;
+class Entry;
+class Group;
+
+/**
+ * Brings a database in line with another copy of itself without replacing it.
+ *
+ * Groups and entries are matched by UUID. Only items that were added, removed, moved
+ * or whose last modification time or history differs are touched, so views attached
+ * to the target database receive one fine-grained update per changed item instead of
+ * a full reset. Unlike Merger, changes of the target that are not in the source are
+ * discarded: afterwards the target has the same content as the source.
+ */
+class DatabaseDiff
+{
+public:
+    DatabaseDiff(const Database* sourceDb, Database* targetDb);
+
+    bool apply();
+    int changes() const;
+
+private:
+    bool canApply() const;
+    void applyCustomIcons();
+    void applyGroup(const Group* sourceGroup, Group* targetGroup);
+    void applyEntry(const Entry* sourceEntry, Group* targetGroup, int index);
+    void applyGroupData(const Group* sourceGroup);
+    void applyMetadata();
+    void removeStaleItems();
+
+    const Database* const m_sourceDb;
+    Database* const m_targetDb;
+    QSet<QUuid> m_sourceEntries;
+    QSet<QUuid> m_sourceGroups;
+    int m_changes;
+};
+
+#endif // KEEPASSXC_DATABASEDIFF_H
@@ -23,6 +23,8 @@
 #include "core/Group.h"
 #include "core/Metadata.h"
 #include "core/PasswordHealth.h"
+#include "core/PasswordHealthCache.h"
+#include "core/ReferenceIndex.h"
 #include "core/Tools.h"
 #include "core/Totp.h"
 
@@ -35,6 +37,12 @@ const int Entry::ResolveMaximumDepth = 10;
 const QString Entry::AutoTypeSequenceUsername = "{USERNAME}{ENTER}";
 const QString Entry::AutoTypeSequencePassword = "{PASSWORD}{ENTER}";
 
+namespace
+{
+    // Set while resolving placeholders whose value changes over time, such as {TOTP}
+    thread_local bool t_volatileResolution = false;
+} // namespace
+
 Entry::Entry()
     : m_attributes(new EntryAttributes(this))
     , m_attachments(new EntryAttachments(this))
@@ -223,7 +231,7 @@ QString Entry::defaultAutoTypeSequence() const
 const QSharedPointer<PasswordHealth> Entry::passwordHealth()
 {
     if (!m_data.passwordHealth) {
-        m_data.passwordHealth.reset(new PasswordHealth(resolvePlaceholder(password())));
+        m_data.passwordHealth = static_cast<const Entry*>(this)->passwordHealth();
     }
     return m_data.passwordHealth;
 }
@@ -231,7 +239,12 @@ const QSharedPointer<PasswordHealth> Entry::passwordHealth()
 const QSharedPointer<PasswordHealth> Entry::passwordHealth() const
 {
     if (!m_data.passwordHealth) {
-        return QSharedPointer<PasswordHealth>::create(resolvePlaceholder(password()));
+        const auto pwd = resolvePlaceholder(password());
+        const auto* db = database();
+        if (db) {
+            return db->passwordHealthCache()->health(pwd);
+        }
+        return QSharedPointer<PasswordHealth>::create(pwd);
     }
     return m_data.passwordHealth;
 }
@@ -429,23 +442,45 @@ QString Entry::attribute(const QString& key) const
     return m_attributes->value(key);
 }
 
+/**
+ * Size of the entry data in bytes, without history. The sizes of the parts of the
+ * entry are cached and only recomputed after they have changed.
+ */
 int Entry::size() const
 {
     int size = 0;
-    const QRegularExpression delimiter(",|:|;");
 
     size += this->attributes()->attributesSize();
     size += this->autoTypeAssociations()->associationsSize();
     size += this->attachments()->attachmentsSize();
     size += this->customData()->dataSize();
-    const QStringList tags = this->tags().split(delimiter, QString::SkipEmptyParts);
-    for (const QString& tag : tags) {
-        size += tag.toUtf8().size();
+
+    if (m_tagsSize < 0) {
+        // Colons count as tag delimiters
+        m_tagsSize = 0;
+        for (const QString& tag : m_data.tags) {
+            m_tagsSize += tag.toUtf8().size() - tag.count(QLatin1Char(':'));
+        }
     }
+    size += m_tagsSize;
 
     return size;
 }
 
+/**
+ * Cumulative size of all history items, cached until the history changes.
+ */
+int Entry::historySize() const
+{
+    if (m_historySize < 0) {
+        m_historySize = 0;
+        for (const Entry* historyItem : m_history) {
+            m_historySize += historyItem->size();
+        }
+    }
+    return m_historySize;
+}
+
 bool Entry::isExpired() const
 {
     return willExpireInDays(0);
@@ -618,7 +653,14 @@ QString Entry::path() const
 void Entry::setUuid(const QUuid& uuid)
 {
     Q_ASSERT(!uuid.isNull());
+    auto db = database();
+    if (db) {
+        db->unindexEntry(this);
+    }
     set(m_uuid, uuid);
+    if (db) {
+        db->indexEntry(this);
+    }
 }
 
 void Entry::setIcon(int iconNumber)
@@ -676,6 +718,7 @@ void Entry::setTags(const QString& tags)
     // Sort alphabetically
     taglist.sort();
     set(m_data.tags, taglist);
+    m_tagsSize = -1;
 }
 
 void Entry::addTag(const QString& tag)
@@ -688,6 +731,7 @@ void Entry::addTag(const QString& tag)
         taglist.append(cleanTag);
         taglist.sort();
         set(m_data.tags, taglist);
+        m_tagsSize = -1;
     }
 }
 
@@ -699,6 +743,7 @@ void Entry::removeTag(const QString& tag)
     auto taglist = m_data.tags;
     if (taglist.removeAll(tag) > 0) {
         set(m_data.tags, taglist);
+        m_tagsSize = -1;
     }
 }
 
@@ -797,6 +842,7 @@ void Entry::addHistoryItem(Entry* entry)
     Q_ASSERT(!entry->parent());
 
     m_history.append(entry);
+    m_historySize = -1;
     emitModified();
 }
 
@@ -814,6 +860,7 @@ void Entry::removeHistoryItems(const QList<Entry*>& historyEntries)
         m_history.removeOne(entry);
         delete entry;
     }
+    m_historySize = -1;
 
     emitModified();
 }
@@ -843,8 +890,9 @@ void Entry::truncateHistory()
         }
     }
 
+    // Most saves stay below the limit, the cumulative size avoids walking the history for them
     int histMaxSize = db->metadata()->historyMaxSize();
-    if (histMaxSize > -1) {
+    if (histMaxSize > -1 && historySize() > histMaxSize) {
         int size = 0;
 
         QMutableListIterator<Entry*> i(m_history);
@@ -866,10 +914,44 @@ void Entry::truncateHistory()
     }
 
     if (changed) {
+        m_historySize = -1;
         emitModified();
     }
 }
 
+/**
+ * Let every history item share the storage of the values that are unchanged in the next
+ * newer revision, so that each item only holds copies of what changed. Values are copied
+ * on write, the history items remain complete entries.
+ */
+void Entry::shareHistoryData()
+{
+    const Entry* newer = this;
+    for (int i = m_history.size() - 1; i >= 0; --i) {
+        m_history[i]->shareDataFrom(newer);
+        newer = m_history[i];
+    }
+}
+
+void Entry::shareDataFrom(const Entry* other)
+{
+    auto shareIfEqual = [](auto& value, const auto& otherValue) {
+        if (value == otherValue) {
+            value = otherValue;
+        }
+    };
+    shareIfEqual(m_data.foregroundColor, other->m_data.foregroundColor);
+    shareIfEqual(m_data.backgroundColor, other->m_data.backgroundColor);
+    shareIfEqual(m_data.overrideUrl, other->m_data.overrideUrl);
+    shareIfEqual(m_data.tags, other->m_data.tags);
+    shareIfEqual(m_data.defaultAutoTypeSequence, other->m_data.defaultAutoTypeSequence);
+
+    m_attributes->shareDataFrom(other->m_attributes);
+    m_attachments->shareDataFrom(other->m_attachments);
+    m_customData->shareDataFrom(other->m_customData);
+    m_autoTypeAssociations->shareDataFrom(other->m_autoTypeAssociations);
+}
+
 bool Entry::equals(const Entry* other, CompareItemOptions options) const
 {
     if (!other) {
@@ -965,6 +1047,7 @@ void Entry::copyDataFrom(const Entry* other)
 {
     setUpdateTimeinfo(false);
     m_data = other->m_data;
+    m_tagsSize = -1;
     m_customData->copyDataFrom(other->m_customData);
     m_attributes->copyDataFrom(other->m_attributes);
     m_attachments->copyDataFrom(other->m_attachments);
@@ -1068,6 +1151,7 @@ QString Entry::resolvePlaceholderRecursive(const QString& placeholder, int maxDe
         }
         return resolveMultiplePlaceholdersRecursive(url(), maxDepth - 1);
     case PlaceholderType::DbDir: {
+        t_volatileResolution = true;
         QFileInfo fileInfo(database()->filePath());
         return fileInfo.absoluteDir().absolutePath();
     }
@@ -1085,6 +1169,7 @@ QString Entry::resolvePlaceholderRecursive(const QString& placeholder, int maxDe
         return resolveUrlPlaceholder(strUrl, typeOfPlaceholder);
     }
     case PlaceholderType::Totp:
+        t_volatileResolution = true;
         // totp can't have placeholder inside
         return totp();
     case PlaceholderType::CustomAttribute: {
@@ -1115,6 +1200,7 @@ QString Entry::resolvePlaceholderRecursive(const QString& placeholder, int maxDe
 
 QString Entry::resolveDateTimePlaceholder(Entry::PlaceholderType placeholderType) const
 {
+    t_volatileResolution = true;
     QDateTime time = Clock::currentDateTime();
     QDateTime time_utc = Clock::currentDateTimeUtc();
     QString date_formatted{};
@@ -1331,12 +1417,48 @@ Entry* Entry::resolveReference(const QString& str) const
 
 QString Entry::resolveMultiplePlaceholders(const QString& str) const
 {
-    return resolveMultiplePlaceholdersRecursive(str, ResolveMaximumDepth);
+    return resolvePlaceholdersCached(str, true);
 }
 
 QString Entry::resolvePlaceholder(const QString& placeholder) const
 {
-    return resolvePlaceholderRecursive(placeholder, ResolveMaximumDepth);
+    return resolvePlaceholdersCached(placeholder, false);
+}
+
+/**
+ * Resolve placeholders using the resolved value cache of the database. Values that
+ * depend on the current time, such as {TOTP} or {DT_SIMPLE}, are never cached.
+ */
+QString Entry::resolvePlaceholdersCached(const QString& str, bool multiple) const
+{
+    // Strings without placeholders resolve to themselves
+    if (!str.contains(QLatin1Char('{'))) {
+        return str;
+    }
+
+    auto db = database();
+    auto referenceIndex = db ? db->referenceIndex() : nullptr;
+
+    QString result;
+    if (referenceIndex && referenceIndex->resolvedValue(this, str, multiple, result)) {
+        return result;
+    }
+
+    const bool wasVolatile = t_volatileResolution;
+    t_volatileResolution = false;
+
+    if (multiple) {
+        result = resolveMultiplePlaceholdersRecursive(str, ResolveMaximumDepth);
+    } else {
+        result = resolvePlaceholderRecursive(str, ResolveMaximumDepth);
+    }
+
+    if (referenceIndex && !t_volatileResolution) {
+        referenceIndex->setResolvedValue(this, str, multiple, result);
+    }
+    t_volatileResolution = t_volatileResolution || wasVolatile;
+
+    return result;
 }
 
 QString Entry::resolveUrlPlaceholder(const QString& str, Entry::PlaceholderType placeholderType) const
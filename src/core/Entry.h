@@ -114,6 +114,7 @@ public:
     const Group* previousParentGroup() const;
     QUuid previousParentGroupUuid() const;
     int size() const;
+    int historySize() const;
     QString path() const;
     const QSharedPointer<PasswordHealth> passwordHealth();
     const QSharedPointer<PasswordHealth> passwordHealth() const;
@@ -168,6 +169,7 @@ public:
     void addHistoryItem(Entry* entry);
     void removeHistoryItems(const QList<Entry*>& historyEntries);
     void truncateHistory();
+    void shareHistoryData();
 
     bool equals(const Entry* other, CompareItemOptions options = CompareItemDefault) const;
 
@@ -278,6 +280,7 @@ private slots:
     void updateTotp();
 
 private:
+    QString resolvePlaceholdersCached(const QString& str, bool multiple) const;
     QString resolveMultiplePlaceholdersRecursive(const QString& str, int maxDepth) const;
     QString resolvePlaceholderRecursive(const QString& placeholder, int maxDepth) const;
     QString resolveReferencePlaceholderRecursive(const QString& placeholder, int maxDepth) const;
@@ -287,6 +290,7 @@ private:
     static EntryReferenceType referenceType(const QString& referenceStr);
 
     template <class T> bool set(T& property, const T& value);
+    void shareDataFrom(const Entry* other);
 
     QUuid m_uuid;
     EntryData m_data;
@@ -300,6 +304,8 @@ private:
     bool m_modifiedSinceBegin;
     QPointer<Group> m_group;
     bool m_updateTimeinfo;
+    mutable int m_tagsSize = -1;
+    mutable int m_historySize = -1;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(Entry::CloneFlags)
@@ -19,6 +19,7 @@
 
 #include "config-keepassx.h"
 #include "core/Global.h"
+#include "core/Tools.h"
 #include "crypto/Random.h"
 
 #include <QDesktopServices>
@@ -69,6 +70,7 @@ void EntryAttachments::set(const QString& key, const QByteArray& value)
 
     if (addAttachment || m_attachments.value(key) != value) {
         m_attachments.insert(key, value);
+        m_attachmentsSize = -1;
         shouldEmitModified = true;
     }
 
@@ -93,6 +95,7 @@ void EntryAttachments::remove(const QString& key)
     emit aboutToBeRemoved(key);
 
     m_attachments.remove(key);
+    m_attachmentsSize = -1;
 
     if (m_openedAttachments.contains(key)) {
         disconnectAndEraseExternalFile(m_openedAttachments.value(key));
@@ -145,6 +148,7 @@ void EntryAttachments::clear()
     emit aboutToBeReset();
 
     m_attachments.clear();
+    m_attachmentsSize = -1;
 
     const auto externalPath = m_openedAttachments.values();
     for (auto& path : externalPath) {
@@ -188,12 +192,22 @@ void EntryAttachments::copyDataFrom(const EntryAttachments* other)
         }
 
         m_attachments = other->m_attachments;
+        m_attachmentsSize = -1;
 
         emit reset();
         emitModified();
     }
 }
 
+/**
+ * Share the storage of all attachments that are equal to the ones of other.
+ * Does not change the content, so no signals are emitted.
+ */
+void EntryAttachments::shareDataFrom(const EntryAttachments* other)
+{
+    Tools::shareEqualValues(m_attachments, other->m_attachments);
+}
+
 bool EntryAttachments::operator==(const EntryAttachments& other) const
 {
     return m_attachments == other.m_attachments;
@@ -206,11 +220,14 @@ bool EntryAttachments::operator!=(const EntryAttachments& other) const
 
 int EntryAttachments::attachmentsSize() const
 {
-    int size = 0;
-    for (auto it = m_attachments.constBegin(); it != m_attachments.constEnd(); ++it) {
-        size += it.key().toUtf8().size() + it.value().size();
+    if (m_attachmentsSize < 0) {
+        int size = 0;
+        for (auto it = m_attachments.constBegin(); it != m_attachments.constEnd(); ++it) {
+            size += it.key().toUtf8().size() + it.value().size();
+        }
+        m_attachmentsSize = size;
     }
-    return size;
+    return m_attachmentsSize;
 }
 
 bool EntryAttachments::openAttachment(const QString& key, QString* errorMessage)
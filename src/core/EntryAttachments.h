@@ -46,6 +46,7 @@ public:
     bool isEmpty() const;
     void clear();
     void copyDataFrom(const EntryAttachments* other);
+    void shareDataFrom(const EntryAttachments* other);
     bool operator==(const EntryAttachments& other) const;
     bool operator!=(const EntryAttachments& other) const;
     int attachmentsSize() const;
@@ -68,6 +69,8 @@ private:
     void disconnectAndEraseExternalFile(const QString& path);
 
     QMap<QString, QByteArray> m_attachments;
+    // Computed on demand, reset whenever an attachment changes
+    mutable int m_attachmentsSize = -1;
     QHash<QString, QString> m_openedAttachments;
     QHash<QString, QString> m_openedAttachmentsInverse;
     QHash<QString, QSharedPointer<FileWatcher>> m_attachmentFileWatchers;
@@ -18,6 +18,7 @@
 
 #include "EntryAttributes.h"
 #include "core/Global.h"
+#include "core/Tools.h"
 
 #include <QRegularExpression>
 #include <QUuid>
@@ -131,6 +132,7 @@ void EntryAttributes::set(const QString& key, const QString& value, bool protect
 
     if (addAttribute || changeValue) {
         m_attributes.insert(key, value);
+        m_attributesSize = -1;
         shouldEmitModified = true;
     }
 
@@ -167,6 +169,7 @@ void EntryAttributes::remove(const QString& key)
     emit aboutToBeRemoved(key);
 
     m_attributes.remove(key);
+    m_attributesSize = -1;
     m_protectedAttributes.remove(key);
 
     emit removed(key);
@@ -195,6 +198,7 @@ void EntryAttributes::rename(const QString& oldKey, const QString& newKey)
 
     m_attributes.remove(oldKey);
     m_attributes.insert(newKey, data);
+    m_attributesSize = -1;
     if (protect) {
         m_protectedAttributes.remove(oldKey);
         m_protectedAttributes.insert(newKey);
@@ -230,6 +234,7 @@ void EntryAttributes::copyCustomKeysFrom(const EntryAttributes* other)
             }
         }
     }
+    m_attributesSize = -1;
 
     emit reset();
     emitModified();
@@ -262,6 +267,7 @@ void EntryAttributes::copyDataFrom(const EntryAttributes* other)
         emit aboutToBeReset();
 
         m_attributes = other->m_attributes;
+        m_attributesSize = -1;
         m_protectedAttributes = other->m_protectedAttributes;
 
         emit reset();
@@ -269,6 +275,18 @@ void EntryAttributes::copyDataFrom(const EntryAttributes* other)
     }
 }
 
+/**
+ * Share the storage of all attributes that are equal to the ones of other.
+ * Does not change the content, so no signals are emitted.
+ */
+void EntryAttributes::shareDataFrom(const EntryAttributes* other)
+{
+    Tools::shareEqualValues(m_attributes, other->m_attributes);
+    if (m_protectedAttributes == other->m_protectedAttributes) {
+        m_protectedAttributes = other->m_protectedAttributes;
+    }
+}
+
 QUuid EntryAttributes::referenceUuid(const QString& key) const
 {
     if (!m_attributes.contains(key)) {
@@ -311,6 +329,7 @@ void EntryAttributes::clear()
     emit aboutToBeReset();
 
     m_attributes.clear();
+    m_attributesSize = -1;
     m_protectedAttributes.clear();
 
     for (const QString& key : DefaultAttributes) {
@@ -323,11 +342,14 @@ void EntryAttributes::clear()
 
 int EntryAttributes::attributesSize() const
 {
-    int size = 0;
-    for (auto it = m_attributes.constBegin(); it != m_attributes.constEnd(); ++it) {
-        size += it.key().toUtf8().size() + it.value().toUtf8().size();
+    if (m_attributesSize < 0) {
+        int size = 0;
+        for (auto it = m_attributes.constBegin(); it != m_attributes.constEnd(); ++it) {
+            size += it.key().toUtf8().size() + it.value().toUtf8().size();
+        }
+        m_attributesSize = size;
     }
-    return size;
+    return m_attributesSize;
 }
 
 bool EntryAttributes::isDefaultAttribute(const QString& key)
@@ -49,6 +49,7 @@ public:
     void clear();
     int attributesSize() const;
     void copyDataFrom(const EntryAttributes* other);
+    void shareDataFrom(const EntryAttributes* other);
     QUuid referenceUuid(const QString& key) const;
     bool operator==(const EntryAttributes& other) const;
     bool operator!=(const EntryAttributes& other) const;
@@ -86,6 +87,8 @@ signals:
 private:
     QMap<QString, QString> m_attributes;
     QSet<QString> m_protectedAttributes;
+    // Computed on demand, reset whenever an attribute changes
+    mutable int m_attributesSize = -1;
 };
 
 #endif // KEEPASSX_ENTRYATTRIBUTES_H
@@ -19,9 +19,13 @@
 #include "EntrySearcher.h"
 
 #include "PasswordHealth.h"
+#include "core/Database.h"
 #include "core/Group.h"
+#include "core/SearchIndex.h"
 #include "core/Tools.h"
 
+#include <QtConcurrent>
+
 EntrySearcher::EntrySearcher(bool caseSensitive, bool skipProtected)
     : m_caseSensitive(caseSensitive)
     , m_skipProtected(skipProtected)
@@ -70,16 +74,60 @@ QList<Entry*> EntrySearcher::repeat(const Group* baseGroup, bool forceSearch)
     Q_ASSERT(baseGroup);
 
     QList<Entry*> results;
+    for (const auto entry : candidateEntries(baseGroup, forceSearch)) {
+        if (searchEntryImpl(entry)) {
+            results.append(entry);
+        }
+    }
+    return results;
+}
+
+/**
+ * Parse the search string and collect the entries of the group, and its
+ * children, that have to be matched against the search terms. Use
+ * filterEntries() to perform the actual matching, possibly in chunks.
+ *
+ * @param searchString search terms
+ * @param baseGroup group to start search from, cannot be null
+ * @param forceSearch ignore group search settings
+ * @return list of entries that may match the search terms
+ */
+QList<Entry*> EntrySearcher::collectEntries(const QString& searchString, const Group* baseGroup, bool forceSearch)
+{
+    Q_ASSERT(baseGroup);
+    parseSearchTerms(searchString);
+    return candidateEntries(baseGroup, forceSearch);
+}
+
+/**
+ * Match the given entries against the current search terms on the global
+ * thread pool. Blocks until all entries have been matched, the entries must
+ * not be modified in the meantime.
+ *
+ * @param entries list of entries to match
+ * @return list of entries that match the search terms, in their original order
+ */
+QList<Entry*> EntrySearcher::filterEntries(const QList<Entry*>& entries) const
+{
+    return QtConcurrent::blockingFiltered(entries, [this](const Entry* entry) { return searchEntryImpl(entry); });
+}
+
+QList<Entry*> EntrySearcher::candidateEntries(const Group* baseGroup, bool forceSearch) const
+{
+    QSet<const Entry*> candidates;
+    bool filtered = findCandidates(baseGroup, candidates);
+
+    QList<Entry*> entries;
     for (const auto group : baseGroup->groupsRecursive(true)) {
         if (forceSearch || group->resolveSearchingEnabled()) {
             for (const auto entry : group->entries()) {
-                if (searchEntryImpl(entry)) {
-                    results.append(entry);
+                if (!filtered || candidates.contains(entry)) {
+                    entries.append(entry);
                 }
             }
         }
     }
-    return results;
+    return entries;
 }
 
 /**
@@ -141,17 +189,53 @@ bool EntrySearcher::isCaseSensitive() const
     return m_caseSensitive;
 }
 
-bool EntrySearcher::searchEntryImpl(const Entry* entry)
+/**
+ * Use the search index of the database, if any, to find the entries
+ * that can possibly match the current search terms.
+ *
+ * @param baseGroup group the search starts from
+ * @param candidates entries that may match
+ * @return false if all entries have to be searched
+ */
+bool EntrySearcher::findCandidates(const Group* baseGroup, QSet<const Entry*>& candidates) const
+{
+    auto db = baseGroup->database();
+    if (!db || !db->searchIndex()) {
+        return false;
+    }
+
+    QStringList fragments;
+    for (const auto& term : m_searchTerms) {
+        if (term.exclude) {
+            continue;
+        }
+        switch (term.field) {
+        case Field::Undefined:
+        case Field::Title:
+        case Field::Username:
+        case Field::Url:
+        case Field::Notes:
+        case Field::AttributeKV:
+        case Field::Tag:
+            fragments << term.fragments;
+            break;
+        default:
+            break;
+        }
+    }
+
+    return db->searchIndex()->candidates(fragments, candidates);
+}
+
+bool EntrySearcher::searchEntryImpl(const Entry* entry) const
 {
-    // Pre-load in case they are needed
-    auto attributes_keys = entry->attributes()->customKeys();
-    auto attributes = QStringList(attributes_keys + entry->attributes()->values(attributes_keys));
-    auto attachments = QStringList(entry->attachments()->keys());
-    // Build a group hierarchy to allow searching for e.g. /group1/subgroup*
+    // Loaded on first use
+    QStringList attributes;
+    QStringList attachments;
     QString hierarchy;
-    if (entry->group()) {
-        hierarchy = entry->group()->hierarchy().join('/').prepend("/");
-    }
+    bool attributesLoaded = false;
+    bool attachmentsLoaded = false;
+    bool hierarchyLoaded = false;
 
     // By default, empty term matches every entry.
     // However when skipping protected fields, we will reject everything instead
@@ -177,9 +261,18 @@ bool EntrySearcher::searchEntryImpl(const Entry* entry)
             found = term.regex.match(entry->notes()).hasMatch();
             break;
         case Field::AttributeKV:
+            if (!attributesLoaded) {
+                auto attributes_keys = entry->attributes()->customKeys();
+                attributes = QStringList(attributes_keys + entry->attributes()->values(attributes_keys));
+                attributesLoaded = true;
+            }
             found = !attributes.filter(term.regex).empty();
             break;
         case Field::Attachment:
+            if (!attachmentsLoaded) {
+                attachments = QStringList(entry->attachments()->keys());
+                attachmentsLoaded = true;
+            }
             found = !attachments.filter(term.regex).empty();
             break;
         case Field::AttributeValue:
@@ -192,6 +285,11 @@ bool EntrySearcher::searchEntryImpl(const Entry* entry)
         case Field::Group:
             // Match against the full hierarchy if the word contains a '/' otherwise just the group name
             if (term.word.contains('/')) {
+                // Build a group hierarchy to allow searching for e.g. /group1/subgroup*
+                if (!hierarchyLoaded && entry->group()) {
+                    hierarchy = entry->group()->hierarchy().join('/').prepend("/");
+                }
+                hierarchyLoaded = true;
                 found = term.regex.match(hierarchy).hasMatch();
             } else if (entry->group()) {
                 found = term.regex.match(entry->group()->name()).hasMatch();
@@ -298,6 +396,12 @@ void EntrySearcher::parseSearchTerms(const QString& searchString)
         }
         term.regex = Tools::convertToRegex(term.word, opts);
 
+        // Wildcards split the word into literal fragments, alternatives can't be used for pre-filtering
+        if ((opts & Tools::RegexConvertOpts::WILDCARD_ALL) && !term.word.contains('|')) {
+            static const QRegularExpression wildcards(R"([*?])");
+            term.fragments = term.word.split(wildcards, QString::SkipEmptyParts);
+        }
+
         // Exclude modifier
         term.exclude = mods.contains("-") || mods.contains("!");
 
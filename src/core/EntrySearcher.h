@@ -20,6 +20,7 @@
 #define KEEPASSX_ENTRYSEARCHER_H
 
 #include <QRegularExpression>
+#include <QSet>
 
 class Group;
 class Entry;
@@ -51,6 +52,8 @@ public:
         QString word;
         QRegularExpression regex;
         bool exclude;
+        // literal text that occurs in every match, used to pre-filter entries with the search index
+        QStringList fragments;
     };
 
     explicit EntrySearcher(bool caseSensitive = false, bool skipProtected = false);
@@ -63,12 +66,17 @@ public:
     QList<Entry*> searchEntries(const QString& searchString, const QList<Entry*>& entries);
     QList<Entry*> repeatEntries(const QList<Entry*>& entries);
 
+    QList<Entry*> collectEntries(const QString& searchString, const Group* baseGroup, bool forceSearch = false);
+    QList<Entry*> filterEntries(const QList<Entry*>& entries) const;
+
     void setCaseSensitive(bool state);
     bool isCaseSensitive() const;
 
 private:
-    bool searchEntryImpl(const Entry* entry);
+    bool searchEntryImpl(const Entry* entry) const;
     void parseSearchTerms(const QString& searchString);
+    QList<Entry*> candidateEntries(const Group* baseGroup, bool forceSearch) const;
+    bool findCandidates(const Group* baseGroup, QSet<const Entry*>& candidates) const;
 
     bool m_caseSensitive;
     bool m_skipProtected;
@@ -19,14 +19,67 @@
 
 #include "core/AsyncTask.h"
 
+#include <QFileInfo>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
 #ifdef Q_OS_LINUX
 #include <sys/statfs.h>
 #endif
 
+namespace
+{
+    // Writes within this time of the modification time may not change it on coarse-grained file systems
+    constexpr int ModificationTimeResolutionMs = 2000;
+
+    // Polling only backs up notifications on file systems known to deliver them reliably
+    constexpr int NotifiedPollingFactor = 4;
+
+#ifdef Q_OS_LINUX
+    /**
+     * Whether the file system is local and reports every change through inotify.
+     * Network and user space file systems (CIFS, FUSE, 9p, ...) only see local writes.
+     */
+    bool isLocalFileSystem(qint64 type)
+    {
+        switch (static_cast<quint32>(type)) {
+        case 0xEF53: // ext2, ext3, ext4
+        case 0x9123683E: // btrfs
+        case 0x58465342: // xfs
+        case 0xF2F52010: // f2fs
+        case 0x2FC12FC1: // zfs
+        case 0x52654973: // reiserfs
+        case 0x3153464A: // jfs
+        case 0xCA451A4E: // bcachefs
+        case 0x01021994: // tmpfs
+        case 0x794C7630: // overlayfs
+            return true;
+        default:
+            return false;
+        }
+    }
+#endif
+} // namespace
+
+bool FileWatcher::FileState::operator==(const FileState& other) const
+{
+    return size == other.size && lastModified == other.lastModified && inode == other.inode;
+}
+
+/**
+ * Whether the file may have been rewritten without changing its metadata.
+ */
+bool FileWatcher::FileState::isAmbiguous() const
+{
+    return size < 0 || !lastModified.isValid() || lastModified.msecsTo(checked) < ModificationTimeResolutionMs;
+}
+
 FileWatcher::FileWatcher(QObject* parent)
     : QObject(parent)
 {
     connect(&m_fileWatcher, SIGNAL(fileChanged(QString)), SLOT(checkFileChanged()));
+    connect(&m_fileWatcher, SIGNAL(directoryChanged(QString)), SLOT(checkFileChanged()));
     connect(&m_fileChecksumTimer, SIGNAL(timeout()), SLOT(checkFileChanged()));
     connect(&m_fileChangeDelayTimer, &QTimer::timeout, this, [this] { emit fileChanged(m_filePath); });
     m_fileChangeDelayTimer.setSingleShot(true);
@@ -38,33 +91,62 @@ FileWatcher::~FileWatcher()
     stop();
 }
 
+/**
+ * Watch a file for changes to its content.
+ *
+ * Changes are picked up through file system notifications for the file and its
+ * directory, which also catch the file being replaced by an atomic save. Only if
+ * its size, modification time or inode changed the file is hashed to find out
+ * whether its content changed.
+ *
+ * The file is polled as well, since notifications miss writes by other clients
+ * on network shares. On local file systems that are known to notify about every
+ * change polling is only a fallback and runs at a lower rate.
+ *
+ * @param filePath path of the file
+ * @param checksumIntervalSeconds interval to poll the file at, 0 to disable polling
+ * @param checksumSizeKibibytes number of KiB at the start of the file to hash, -1 for all
+ */
 void FileWatcher::start(const QString& filePath, int checksumIntervalSeconds, int checksumSizeKibibytes)
 {
     stop();
 
+    bool notificationsReliable = false;
+
 #if defined(Q_OS_LINUX)
     struct statfs statfsBuf;
-    bool forcePolling = false;
     const auto NFS_SUPER_MAGIC = 0x6969;
 
+    bool notificationsUnsupported = false;
     if (!statfs(filePath.toLocal8Bit().constData(), &statfsBuf)) {
-        forcePolling = (statfsBuf.f_type == NFS_SUPER_MAGIC);
+        notificationsUnsupported = (statfsBuf.f_type == NFS_SUPER_MAGIC);
+        notificationsReliable = isLocalFileSystem(static_cast<qint64>(statfsBuf.f_type));
     } else {
         // if we can't get the fs type let's fall back to polling
-        forcePolling = true;
+        notificationsUnsupported = true;
     }
-    auto objectName = forcePolling ? QLatin1String("_qt_autotest_force_engine_poller") : QLatin1String("");
+    auto objectName =
+        notificationsUnsupported ? QLatin1String("_qt_autotest_force_engine_poller") : QLatin1String("");
     m_fileWatcher.setObjectName(objectName);
 #endif
 
-    m_fileWatcher.addPath(filePath);
+    if (!m_fileWatcher.addPath(filePath)) {
+        notificationsReliable = false;
+    }
+    // Atomic saves replace the file, which drops the watch on the file itself
+    m_fileWatcher.addPath(QFileInfo(filePath).absolutePath());
     m_filePath = filePath;
 
     // Handle file checksum
     m_fileChecksumSizeBytes = checksumSizeKibibytes * 1024;
+    m_fileState = readFileState();
     m_fileChecksum = calculateChecksum();
     if (checksumIntervalSeconds > 0) {
-        m_fileChecksumTimer.start(checksumIntervalSeconds * 1000);
+        int intervalSeconds = checksumIntervalSeconds;
+        if (notificationsReliable) {
+            intervalSeconds *= NotifiedPollingFactor;
+        }
+        m_fileChecksumTimer.start(intervalSeconds * 1000);
     }
 
     m_ignoreFileChange = false;
@@ -72,11 +154,15 @@ void FileWatcher::start(const QString& filePath, int checksumIntervalSeconds, in
 
 void FileWatcher::stop()
 {
-    if (!m_filePath.isEmpty()) {
-        m_fileWatcher.removePath(m_filePath);
+    if (!m_fileWatcher.files().isEmpty()) {
+        m_fileWatcher.removePaths(m_fileWatcher.files());
+    }
+    if (!m_fileWatcher.directories().isEmpty()) {
+        m_fileWatcher.removePaths(m_fileWatcher.directories());
     }
     m_filePath.clear();
     m_fileChecksum.clear();
+    m_fileState = {};
     m_fileChecksumTimer.stop();
     m_fileChangeDelayTimer.stop();
 }
@@ -113,12 +199,23 @@ void FileWatcher::checkFileChanged()
         return;
     }
 
+    if (!m_fileWatcher.files().contains(m_filePath) && QFileInfo::exists(m_filePath)) {
+        m_fileWatcher.addPath(m_filePath);
+    }
+
+    // Only hash the file if its metadata does not rule out a change
+    auto fileState = readFileState();
+    if (fileState == m_fileState && !m_fileState.isAmbiguous()) {
+        return;
+    }
+
     // Prevent reentrance
     m_ignoreFileChange = true;
 
     AsyncTask::runThenCallback([=] { return calculateChecksum(); },
                                this,
                                [=](QByteArray checksum) {
+                                   m_fileState = fileState;
                                    if (checksum != m_fileChecksum) {
                                        m_fileChecksum = checksum;
                                        m_fileChangeDelayTimer.start(0);
@@ -144,3 +241,25 @@ QByteArray FileWatcher::calculateChecksum()
     // prevents unnecessary merge requests on intermittent network shares
     return m_fileChecksum;
 }
+
+FileWatcher::FileState FileWatcher::readFileState() const
+{
+    FileState state;
+    state.checked = QDateTime::currentDateTimeUtc();
+
+    QFileInfo info(m_filePath);
+    if (!info.exists()) {
+        return state;
+    }
+    state.size = info.size();
+    state.lastModified = info.lastModified().toUTC();
+
+#ifdef Q_OS_UNIX
+    struct stat statBuf;
+    if (!stat(m_filePath.toLocal8Bit().constData(), &statBuf)) {
+        state.inode = static_cast<quint64>(statBuf.st_ino);
+    }
+#endif
+
+    return state;
+}
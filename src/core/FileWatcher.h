@@ -18,6 +18,7 @@
 #ifndef KEEPASSXC_FILEWATCHER_H
 #define KEEPASSXC_FILEWATCHER_H
 
+#include <QDateTime>
 #include <QFileSystemWatcher>
 #include <QTimer>
 
@@ -45,12 +46,26 @@ private slots:
     void checkFileChanged();
 
 private:
+    // File metadata that changes whenever the file is rewritten or replaced
+    struct FileState
+    {
+        qint64 size = -1;
+        QDateTime lastModified;
+        quint64 inode = 0;
+        QDateTime checked;
+
+        bool operator==(const FileState& other) const;
+        bool isAmbiguous() const;
+    };
+
     QByteArray calculateChecksum();
+    FileState readFileState() const;
     bool shouldIgnoreChanges();
 
     QString m_filePath;
     QFileSystemWatcher m_fileWatcher;
     QByteArray m_fileChecksum;
+    FileState m_fileState;
     QTimer m_fileChangeDelayTimer;
     QTimer m_fileIgnoreDelayTimer;
     QTimer m_fileChecksumTimer;
@@ -27,6 +27,7 @@
 
 #include "core/Global.h"
 #include "core/Metadata.h"
+#include "core/ReferenceIndex.h"
 #include "core/Tools.h"
 
 #include <QtConcurrent>
@@ -67,6 +68,10 @@ Group::~Group()
         delete group;
     }
 
+    if (m_db) {
+        m_db->unindexGroup(this);
+    }
+
     if (m_db && m_parent) {
         DeletedObject delGroup;
         delGroup.deletionTime = Clock::currentDateTimeUtc();
@@ -338,7 +343,13 @@ bool Group::equals(const Group* other, CompareItemOptions options) const
 
 void Group::setUuid(const QUuid& uuid)
 {
+    if (m_db) {
+        m_db->unindexGroup(this);
+    }
     set(m_uuid, uuid);
+    if (m_db) {
+        m_db->indexGroup(this);
+    }
 }
 
 void Group::setName(const QString& name)
@@ -493,6 +504,11 @@ void Group::setParent(Group* parent, int index, bool trackPrevious)
         QObject::setParent(parent);
         Q_ASSERT(index <= parent->m_children.size());
         parent->m_children.insert(index, this);
+
+        // Entries may have moved in or out of the recycle bin
+        for (const auto* entry : entriesRecursive()) {
+            m_db->updateEntryStatistics(entry);
+        }
     }
 
     if (m_updateTimeinfo) {
@@ -603,6 +619,16 @@ QList<Entry*> Group::entriesRecursive(bool includeHistoryItems) const
 
 QList<Entry*> Group::referencesRecursive(const Entry* entry) const
 {
+    if (m_db && m_db->rootGroup()->isAncestorOf(this)) {
+        QList<Entry*> references;
+        for (auto reference : m_db->referenceIndex()->referencingEntries(entry->uuid())) {
+            if (isAncestorOf(reference->group())) {
+                references.append(reference);
+            }
+        }
+        return references;
+    }
+
     auto entries = entriesRecursive();
     return QtConcurrent::blockingFiltered(entries,
                                           [entry](const Entry* e) { return e->hasReferencesTo(entry->uuid()); });
@@ -614,6 +640,16 @@ Entry* Group::findEntryByUuid(const QUuid& uuid, bool recursive) const
         return nullptr;
     }
 
+    if (m_db) {
+        // Use the database index instead of walking the tree
+        for (auto entry : m_db->m_entryIndex.values(uuid)) {
+            if (entry->group() == this || (recursive && isAncestorOf(entry->group()))) {
+                return entry;
+            }
+        }
+        return nullptr;
+    }
+
     auto entries = m_entries;
     if (recursive) {
         entries = entriesRecursive(false);
@@ -649,6 +685,13 @@ Entry* Group::findEntryBySearchTerm(const QString& term, EntryReferenceType refe
                "Database::findEntryRecursive",
                "Can't search entry with \"referenceType\" parameter equal to \"Unknown\"");
 
+    if (referenceType == EntryReferenceType::QUuid) {
+        return findEntryByUuid(Tools::hexToUuid(term));
+    }
+    if (m_db && m_db->rootGroup() == this) {
+        return m_db->referenceIndex()->findEntry(term, referenceType);
+    }
+
     const QList<Group*> groups = groupsRecursive(true);
 
     for (const Group* group : groups) {
@@ -877,6 +920,15 @@ Group* Group::findGroupByUuid(const QUuid& uuid)
         return nullptr;
     }
 
+    if (m_db) {
+        for (auto group : m_db->m_groupIndex.values(uuid)) {
+            if (isAncestorOf(group)) {
+                return group;
+            }
+        }
+        return nullptr;
+    }
+
     for (Group* group : groupsRecursive(true)) {
         if (group->uuid() == uuid) {
             return group;
@@ -892,6 +944,15 @@ const Group* Group::findGroupByUuid(const QUuid& uuid) const
         return nullptr;
     }
 
+    if (m_db) {
+        for (auto group : m_db->m_groupIndex.values(uuid)) {
+            if (isAncestorOf(group)) {
+                return group;
+            }
+        }
+        return nullptr;
+    }
+
     for (const Group* group : groupsRecursive(true)) {
         if (group->uuid() == uuid) {
             return group;
@@ -982,7 +1043,8 @@ void Group::addEntry(Entry* entry)
     m_entries << entry;
     connect(entry, &Entry::entryDataChanged, this, &Group::entryDataChanged);
     if (m_db) {
-        connect(entry, &Entry::modified, m_db, &Database::markAsModified);
+        connectEntrySignals(entry, m_db);
+        m_db->indexEntry(entry);
     }
 
     emitModified();
@@ -1000,6 +1062,7 @@ void Group::removeEntry(Entry* entry)
     entry->disconnect(this);
     if (m_db) {
         entry->disconnect(m_db);
+        m_db->unindexEntry(entry);
     }
     m_entries.removeAll(entry);
     emitModified();
@@ -1034,16 +1097,30 @@ void Group::moveEntryDown(Entry* entry)
 
 void Group::connectDatabaseSignalsRecursive(Database* db)
 {
+    bool reindex = (m_db != db);
+
     if (m_db) {
         disconnect(m_db);
+        if (reindex) {
+            m_db->unindexGroup(this);
+        }
+    }
+    if (db && reindex) {
+        db->indexGroup(this);
     }
 
     for (Entry* entry : asConst(m_entries)) {
         if (m_db) {
             entry->disconnect(m_db);
+            if (reindex) {
+                m_db->unindexEntry(entry);
+            }
         }
         if (db) {
-            connect(entry, &Entry::modified, db, &Database::markAsModified);
+            connectEntrySignals(entry, db);
+            if (reindex) {
+                db->indexEntry(entry);
+            }
         }
     }
 
@@ -1068,6 +1145,22 @@ void Group::connectDatabaseSignalsRecursive(Database* db)
     }
 }
 
+void Group::connectEntrySignals(Entry* entry, Database* db)
+{
+    connect(entry, &Entry::modified, db, &Database::markAsModified);
+    connect(entry, &Entry::modified, db, [db, entry] { db->updateEntryStatistics(entry); });
+}
+
+bool Group::isAncestorOf(const Group* group) const
+{
+    for (; group; group = group->m_parent) {
+        if (group == this) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void Group::cleanupParent()
 {
     if (m_parent) {
@@ -20,8 +20,12 @@
 #include "core/Group.h"
 
 #include <QCryptographicHash>
+#include <QFile>
+#include <QMap>
 #include <QProcess>
 
+#include <cstring>
+
 namespace HibpOffline
 {
     const std::size_t SHA1_BYTES = 20;
@@ -106,6 +110,223 @@ namespace HibpOffline
         }
     }
 
+    int hexValue(char c)
+    {
+        if ('0' <= c && c <= '9') {
+            return c - '0';
+        } else if ('a' <= c && c <= 'f') {
+            return c - 'a' + 10;
+        } else if ('A' <= c && c <= 'F') {
+            return c - 'A' + 10;
+        }
+        return -1;
+    }
+
+    /**
+     * Read-only view on a memory-mapped HIBP file, addressing records by byte offset.
+     */
+    class MappedHibpFile
+    {
+    public:
+        MappedHibpFile(const uchar* data, qint64 size)
+            : m_data(reinterpret_cast<const char*>(data))
+            , m_size(size)
+        {
+        }
+
+        bool isLineBreak(qint64 pos) const
+        {
+            return m_data[pos] == '\n' || m_data[pos] == '\r';
+        }
+
+        /**
+         * Find the first record at or after the line containing pos, never moving before lowerBound.
+         * Returns false if there is no record between pos and upperBound.
+         */
+        bool recordAt(qint64 pos, qint64 lowerBound, qint64 upperBound, qint64& start) const
+        {
+            start = pos;
+            while (start > lowerBound && m_data[start - 1] != '\n') {
+                --start;
+            }
+            while (start < upperBound && isLineBreak(start)) {
+                ++start;
+            }
+            return start < upperBound;
+        }
+
+        /**
+         * Parse the record starting at pos. On success end points past the line break(s) of the record.
+         */
+        ParseResult parseRecord(qint64 pos, char* sha1, int& count, qint64& end) const
+        {
+            if (m_size - pos < static_cast<qint64>(SHA1_BYTES * 2 + 1)) {
+                return ParseResult::Error;
+            }
+
+            for (std::size_t i = 0; i < SHA1_BYTES; ++i) {
+                const int high = hexValue(m_data[pos + 2 * i]);
+                const int low = hexValue(m_data[pos + 2 * i + 1]);
+                if (high < 0 || low < 0) {
+                    return ParseResult::Error;
+                }
+                sha1[i] = static_cast<char>((high << 4) | low);
+            }
+
+            end = pos + static_cast<qint64>(SHA1_BYTES * 2);
+            if (m_data[end++] != ':') {
+                return ParseResult::Error;
+            }
+
+            count = 0;
+            const qint64 digitsStart = end;
+            while (end < m_size && !isLineBreak(end)) {
+                const char c = m_data[end++];
+                if (!('0' <= c && c <= '9')) {
+                    return ParseResult::Error;
+                }
+                count *= 10;
+                count += (c - '0');
+            }
+            if (end == digitsStart) {
+                return ParseResult::Error;
+            }
+
+            while (end < m_size && isLineBreak(end)) {
+                ++end;
+            }
+            return ParseResult::Ok;
+        }
+
+        /**
+         * Sample records spread evenly over the file and check they are ordered by hash.
+         */
+        ParseResult checkOrdered(bool& ordered) const
+        {
+            const qint64 samples = 1024;
+            QByteArray previous;
+            char sha1[SHA1_BYTES];
+            int count;
+            qint64 start;
+            qint64 end;
+
+            ordered = true;
+            for (qint64 i = 0; i < samples; ++i) {
+                if (!recordAt(m_size * i / samples, 0, m_size, start)) {
+                    break;
+                }
+                if (parseRecord(start, sha1, count, end) != ParseResult::Ok) {
+                    return ParseResult::Error;
+                }
+                const QByteArray current(sha1, SHA1_BYTES);
+                if (current < previous) {
+                    ordered = false;
+                    return ParseResult::Ok;
+                }
+                previous = current;
+            }
+            return ParseResult::Ok;
+        }
+
+        /**
+         * Binary search for sha1 between the record starting at lo and upperBound.
+         * On return lo is the offset of the matching record, or of the first record past it.
+         */
+        ParseResult find(const QByteArray& sha1, qint64& lo, qint64 upperBound, int& count) const
+        {
+            qint64 hi = upperBound;
+            char recordSha1[SHA1_BYTES];
+            qint64 start;
+            qint64 end;
+
+            while (lo < hi) {
+                if (!recordAt(lo + (hi - lo) / 2, lo, hi, start)) {
+                    hi = lo + (hi - lo) / 2;
+                    continue;
+                }
+                if (parseRecord(start, recordSha1, count, end) != ParseResult::Ok) {
+                    lo = start;
+                    return ParseResult::Error;
+                }
+
+                const int cmp = std::memcmp(sha1.constData(), recordSha1, SHA1_BYTES);
+                if (cmp == 0) {
+                    lo = start;
+                    return ParseResult::Ok;
+                } else if (cmp < 0) {
+                    hi = start;
+                } else {
+                    lo = end;
+                }
+            }
+            return ParseResult::Eof;
+        }
+
+    private:
+        const char* m_data;
+        const qint64 m_size;
+    };
+
+    bool mappedReport(QSharedPointer<Database> db,
+                      QFile& hibpFile,
+                      QList<QPair<const Entry*, int>>& findings,
+                      QString* error)
+    {
+        const qint64 size = hibpFile.size();
+        if (size == 0) {
+            return true;
+        }
+
+        uchar* data = hibpFile.map(0, size);
+        if (!data) {
+            return false;
+        }
+
+        const MappedHibpFile mapped(data, size);
+
+        bool ordered = false;
+        if (mapped.checkOrdered(ordered) == ParseResult::Error) {
+            *error = QObject::tr("HIBP file: parse error");
+            hibpFile.unmap(data);
+            return false;
+        }
+        if (!ordered) {
+            hibpFile.unmap(data);
+            return false;
+        }
+
+        // Search the hashes in ascending order so every lookup can start where the previous one ended
+        QMap<QByteArray, QList<const Entry*>> entriesBySha1;
+        for (const auto* entry : db->rootGroup()->entriesRecursive()) {
+            if (!entry->isRecycled()) {
+                const auto sha1 = QCryptographicHash::hash(entry->password().toUtf8(), QCryptographicHash::Sha1);
+                entriesBySha1[sha1].append(entry);
+            }
+        }
+
+        qint64 lo = 0;
+        for (auto it = entriesBySha1.constBegin(); it != entriesBySha1.constEnd(); ++it) {
+            int count = 0;
+
+            switch (mapped.find(it.key(), lo, size, count)) {
+            case ParseResult::Error:
+                *error = QObject::tr("HIBP file, offset %1: parse error").arg(lo);
+                hibpFile.unmap(data);
+                return false;
+            case ParseResult::Ok:
+                for (const auto* entry : it.value()) {
+                    findings.append({entry, count});
+                }
+                break;
+            default:
+                break;
+            }
+        }
+
+        hibpFile.unmap(data);
+        return true;
+    }
+
     bool okonReport(QSharedPointer<Database> db,
                     const QString& okon,
                     const QString& okonDatabase,
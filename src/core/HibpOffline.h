@@ -20,6 +20,7 @@
 
 #include <QSharedPointer>
 
+class QFile;
 class QIODevice;
 
 class Database;
@@ -32,6 +33,18 @@ namespace HibpOffline
                 QList<QPair<const Entry*, int>>& findings,
                 QString* error);
 
+    /**
+     * Look up the entry passwords in a HIBP file ordered by hash by memory-mapping
+     * the file and binary searching it for every password hash.
+     *
+     * Returns false with an empty error if the file cannot be mapped or is not
+     * ordered by hash, in which case report() has to be used instead.
+     */
+    bool mappedReport(QSharedPointer<Database> db,
+                      QFile& hibpFile,
+                      QList<QPair<const Entry*, int>>& findings,
+                      QString* error);
+
     bool okonReport(QSharedPointer<Database> db,
                     const QString& okon,
                     const QString& okonDatabase,
@@ -19,6 +19,40 @@
 
 #include "core/Metadata.h"
 
+#include <QtConcurrent>
+
+namespace
+{
+    /**
+     * Whether merging the entries cannot change the target: both were last modified at the same time
+     * and have history items with the same, strictly increasing modification times. The target is kept
+     * as it is then, differing content would only be reported as a conflict.
+     */
+    bool isUnchanged(const Entry* sourceEntry, const Entry* targetEntry)
+    {
+        if (Clock::serialized(sourceEntry->timeInfo().lastModificationTime())
+            != Clock::serialized(targetEntry->timeInfo().lastModificationTime())) {
+            return false;
+        }
+        const auto& sourceHistoryItems = sourceEntry->historyItems();
+        const auto& targetHistoryItems = targetEntry->historyItems();
+        if (sourceHistoryItems.size() != targetHistoryItems.size()) {
+            return false;
+        }
+        QDateTime previousModificationTime;
+        for (int i = 0; i < sourceHistoryItems.size(); ++i) {
+            const QDateTime modificationTime =
+                Clock::serialized(sourceHistoryItems[i]->timeInfo().lastModificationTime());
+            if (modificationTime != Clock::serialized(targetHistoryItems[i]->timeInfo().lastModificationTime())
+                || (previousModificationTime.isValid() && modificationTime <= previousModificationTime)) {
+                return false;
+            }
+            previousModificationTime = modificationTime;
+        }
+        return true;
+    }
+} // namespace
+
 Merger::Merger(const Database* sourceDb, Database* targetDb)
     : m_mode(Group::Default)
 {
@@ -62,7 +96,8 @@ QStringList Merger::merge()
     // Order of merge steps is important - it is possible that we
     // create some items before deleting them afterwards
     ChangeList changes;
-    changes << mergeGroup(m_context);
+    const EntryMerges entryMerges = planEntryMerges(m_context);
+    changes << mergeGroup(m_context, entryMerges);
     changes << mergeDeletions(m_context);
     changes << mergeMetadata(m_context);
 
@@ -73,7 +108,13 @@ QStringList Merger::merge()
     return changes;
 }
 
-Merger::ChangeList Merger::mergeGroup(const MergeContext& context)
+/**
+ * Create, relocate and update the groups and entries of the source group in the target database.
+ *
+ * The conflicts of entries that exist in both databases are resolved with the merges planned by
+ * planEntryMerges().
+ */
+Merger::ChangeList Merger::mergeGroup(const MergeContext& context, const EntryMerges& entryMerges)
 {
     ChangeList changes;
     // merge entries
@@ -93,7 +134,14 @@ Merger::ChangeList Merger::mergeGroup(const MergeContext& context)
                 changes << tr("Relocating %1 [%2]").arg(sourceEntry->title(), sourceEntry->uuidToHex());
                 moveEntry(targetEntry, context.m_targetGroup);
             }
-            changes << resolveEntryConflict(context, sourceEntry, targetEntry);
+            auto entryMerge = entryMerges.constFind(sourceEntry);
+            if (entryMerge != entryMerges.constEnd() && entryMerge->targetEntry == targetEntry) {
+                changes << resolveEntryConflict(context, entryMerge.value());
+            } else {
+                // Only happens if the entry was created by this merge, e.g. for duplicated UUIDs in the source
+                const int maxItems = context.m_targetDb->metadata()->historyMaxItems();
+                changes << resolveEntryConflict(context, planEntryMerge(sourceEntry, targetEntry, maxItems));
+            }
         }
     }
 
@@ -126,7 +174,7 @@ Merger::ChangeList Merger::mergeGroup(const MergeContext& context)
                                 context.m_targetRootGroup,
                                 sourceChildGroup,
                                 targetChildGroup};
-        changes << mergeGroup(subcontext);
+        changes << mergeGroup(subcontext, entryMerges);
     }
     return changes;
 }
@@ -250,70 +298,109 @@ void Merger::eraseGroup(Group* group)
     database->setDeletedObjects(deletions);
 }
 
-Merger::ChangeList Merger::resolveEntryConflict_MergeHistories(const MergeContext& context,
-                                                               const Entry* sourceEntry,
-                                                               Entry* targetEntry,
-                                                               Group::MergeMode mergeMethod)
+/**
+ * Plan the merges of all entries of the source group that exist in both databases.
+ *
+ * The merged histories only depend on the two entries of a pair, so they are planned concurrently
+ * without touching either database. mergeGroup() applies them while it walks the tree, so the
+ * target ends up exactly as with a sequential merge.
+ */
+Merger::EntryMerges Merger::planEntryMerges(const MergeContext& context)
+{
+    QList<EntryMerge> plannedMerges;
+    for (const Entry* sourceEntry : context.m_sourceGroup->entriesRecursive()) {
+        Entry* targetEntry = context.m_targetRootGroup->findEntryByUuid(sourceEntry->uuid());
+        if (targetEntry) {
+            plannedMerges.append({sourceEntry, targetEntry, false, {}});
+        }
+    }
+
+    const int maxItems = context.m_targetDb->metadata()->historyMaxItems();
+    QtConcurrent::blockingMap(plannedMerges, [maxItems](EntryMerge& entryMerge) {
+        entryMerge = planEntryMerge(entryMerge.sourceEntry, entryMerge.targetEntry, maxItems);
+    });
+
+    EntryMerges entryMerges;
+    entryMerges.reserve(plannedMerges.size());
+    for (const EntryMerge& entryMerge : asConst(plannedMerges)) {
+        entryMerges.insert(entryMerge.sourceEntry, entryMerge);
+    }
+    return entryMerges;
+}
+
+/**
+ * Determine how the source entry is merged into the target entry without modifying either of them.
+ */
+Merger::EntryMerge Merger::planEntryMerge(const Entry* sourceEntry, Entry* targetEntry, int maxItems)
+{
+    EntryMerge entryMerge{sourceEntry, targetEntry, false, {}};
+    // We need to cut off the milliseconds since the persistent format only supports times down to seconds
+    // so when we import data from a remote source, it may represent the (or even some msec newer) data
+    // which may be discarded due to higher runtime precision
+    entryMerge.sourceIsNewer = compare(targetEntry->timeInfo().lastModificationTime(),
+                                       sourceEntry->timeInfo().lastModificationTime(),
+                                       CompareItemIgnoreMilliseconds)
+                               < 0;
+    if (entryMerge.sourceIsNewer) {
+        // The source ends up on top, the target is merged into its history
+        entryMerge.history = planHistoryMerge(targetEntry, sourceEntry, maxItems);
+    } else if (!isUnchanged(sourceEntry, targetEntry)) {
+        entryMerge.history = planHistoryMerge(sourceEntry, targetEntry, maxItems);
+    }
+    return entryMerge;
+}
+
+Merger::ChangeList Merger::resolveEntryConflict(const MergeContext& context, const EntryMerge& entryMerge)
 {
     Q_UNUSED(context);
 
     ChangeList changes;
-    const int comparison = compare(targetEntry->timeInfo().lastModificationTime(),
-                                   sourceEntry->timeInfo().lastModificationTime(),
-                                   CompareItemIgnoreMilliseconds);
-    const int maxItems = targetEntry->database()->metadata()->historyMaxItems();
-    if (comparison < 0) {
+    const Entry* sourceEntry = entryMerge.sourceEntry;
+    Entry* targetEntry = entryMerge.targetEntry;
+    if (entryMerge.sourceIsNewer) {
         Group* currentGroup = targetEntry->group();
-        Entry* clonedEntry = sourceEntry->clone(Entry::CloneIncludeHistory);
+        // Without changes the history of the source is kept as it is
+        Entry* clonedEntry =
+            sourceEntry->clone(entryMerge.history.changed ? Entry::CloneNoFlags : Entry::CloneIncludeHistory);
         qDebug("Merge %s/%s with alien on top under %s",
                qPrintable(targetEntry->title()),
                qPrintable(sourceEntry->title()),
                qPrintable(currentGroup->name()));
         changes << tr("Synchronizing from newer source %1 [%2]").arg(targetEntry->title(), targetEntry->uuidToHex());
-        mergeHistory(targetEntry, clonedEntry, mergeMethod, maxItems);
+        if (entryMerge.history.changed) {
+            applyHistoryMerge(entryMerge.history, clonedEntry);
+        }
         eraseEntry(targetEntry);
         moveEntry(clonedEntry, currentGroup);
-    } else {
+    } else if (entryMerge.history.changed) {
         qDebug("Merge %s/%s with local on top/under %s",
                qPrintable(targetEntry->title()),
                qPrintable(sourceEntry->title()),
                qPrintable(targetEntry->group()->name()));
-        const bool changed = mergeHistory(sourceEntry, targetEntry, mergeMethod, maxItems);
-        if (changed) {
-            changes
-                << tr("Synchronizing from older source %1 [%2]").arg(targetEntry->title(), targetEntry->uuidToHex());
-        }
+        applyHistoryMerge(entryMerge.history, targetEntry);
+        changes << tr("Synchronizing from older source %1 [%2]").arg(targetEntry->title(), targetEntry->uuidToHex());
     }
     return changes;
 }
 
-Merger::ChangeList
-Merger::resolveEntryConflict(const MergeContext& context, const Entry* sourceEntry, Entry* targetEntry)
-{
-    // We need to cut off the milliseconds since the persistent format only supports times down to seconds
-    // so when we import data from a remote source, it may represent the (or even some msec newer) data
-    // which may be discarded due to higher runtime precision
-
-    Group::MergeMode mergeMode = m_mode == Group::Default ? context.m_targetGroup->mergeMode() : m_mode;
-    return resolveEntryConflict_MergeHistories(context, sourceEntry, targetEntry, mergeMode);
-}
-
-bool Merger::mergeHistory(const Entry* sourceEntry,
-                          Entry* targetEntry,
-                          Group::MergeMode mergeMethod,
-                          const int maxItems)
+/**
+ * Determine the history of the target entry after merging the source entry into it.
+ *
+ * Neither entry is modified, so this is safe to call concurrently for different entries.
+ */
+Merger::HistoryMerge
+Merger::planHistoryMerge(const Entry* sourceEntry, const Entry* targetEntry, const int maxItems)
 {
-    Q_UNUSED(mergeMethod);
-    const auto targetHistoryItems = targetEntry->historyItems();
-    const auto sourceHistoryItems = sourceEntry->historyItems();
+    const auto& targetHistoryItems = targetEntry->historyItems();
+    const auto& sourceHistoryItems = sourceEntry->historyItems();
     const int comparison = compare(sourceEntry->timeInfo().lastModificationTime(),
                                    targetEntry->timeInfo().lastModificationTime(),
                                    CompareItemIgnoreMilliseconds);
     const bool preferLocal = comparison < 0;
     const bool preferRemote = comparison > 0;
 
-    QMap<QDateTime, Entry*> merged;
-    for (Entry* historyItem : targetHistoryItems) {
+    QMap<QDateTime, const Entry*> merged;
+    for (const Entry* historyItem : targetHistoryItems) {
         const QDateTime modificationTime = Clock::serialized(historyItem->timeInfo().lastModificationTime());
         if (merged.contains(modificationTime)
             && !merged[modificationTime]->equals(historyItem, CompareItemIgnoreMilliseconds)) {
@@ -323,9 +410,9 @@ bool Merger::mergeHistory(const Entry* sourceEntry,
                        qPrintable(sourceEntry->uuidToHex()),
                        qPrintable(modificationTime.toString("yyyy-MM-dd HH-mm-ss-zzz")));
         }
-        merged[modificationTime] = historyItem->clone(Entry::CloneNoFlags);
+        merged[modificationTime] = historyItem;
     }
-    for (Entry* historyItem : sourceHistoryItems) {
+    for (const Entry* historyItem : sourceHistoryItems) {
         // Items with same modification-time changes will be regarded as same (like KeePass2)
         const QDateTime modificationTime = Clock::serialized(historyItem->timeInfo().lastModificationTime());
         if (merged.contains(modificationTime)
@@ -336,12 +423,9 @@ bool Merger::mergeHistory(const Entry* sourceEntry,
                 qPrintable(sourceEntry->uuidToHex()),
                 qPrintable(modificationTime.toString("yyyy-MM-dd HH-mm-ss-zzz")));
         }
-        if (preferRemote && merged.contains(modificationTime)) {
+        if (preferRemote || !merged.contains(modificationTime)) {
             // forcefully apply the remote history item
-            delete merged.take(modificationTime);
-        }
-        if (!merged.contains(modificationTime)) {
-            merged[modificationTime] = historyItem->clone(Entry::CloneNoFlags);
+            merged[modificationTime] = historyItem;
         }
     }
 
@@ -356,58 +440,63 @@ bool Merger::mergeHistory(const Entry* sourceEntry,
     }
 
     if (targetModificationTime < sourceModificationTime) {
-        if (preferLocal && merged.contains(targetModificationTime)) {
+        if (preferLocal || !merged.contains(targetModificationTime)) {
             // forcefully apply the local history item
-            delete merged.take(targetModificationTime);
-        }
-        if (!merged.contains(targetModificationTime)) {
-            merged[targetModificationTime] = targetEntry->clone(Entry::CloneNoFlags);
+            merged[targetModificationTime] = targetEntry;
         }
     } else if (targetModificationTime > sourceModificationTime) {
-        if (preferRemote && !merged.contains(sourceModificationTime)) {
-            // forcefully apply the remote history item
-            delete merged.take(sourceModificationTime);
-        }
         if (!merged.contains(sourceModificationTime)) {
-            merged[sourceModificationTime] = sourceEntry->clone(Entry::CloneNoFlags);
+            merged[sourceModificationTime] = sourceEntry;
         }
     }
 
-    bool changed = false;
-    const auto updatedHistoryItems = merged.values();
+    HistoryMerge history;
+    history.items = merged.values();
     for (int i = 0; i < maxItems; ++i) {
         const Entry* oldEntry = targetHistoryItems.value(targetHistoryItems.count() - i);
-        const Entry* newEntry = updatedHistoryItems.value(updatedHistoryItems.count() - i);
-        if (!oldEntry && !newEntry) {
+        const Entry* newEntry = history.items.value(history.items.count() - i);
+        if (oldEntry == newEntry) {
             continue;
         }
         if (oldEntry && newEntry && oldEntry->equals(newEntry, CompareItemIgnoreMilliseconds)) {
             continue;
         }
-        changed = true;
+        history.changed = true;
         break;
     }
-    if (!changed) {
-        qDeleteAll(updatedHistoryItems);
-        return false;
+    return history;
+}
+
+/**
+ * Replace the history of the target entry with copies of the planned history items.
+ */
+void Merger::applyHistoryMerge(const HistoryMerge& history, Entry* targetEntry)
+{
+    // The planned items may belong to the target itself, so they are copied before the history is cleared
+    QList<Entry*> historyItems;
+    historyItems.reserve(history.items.size());
+    for (const Entry* historyItem : history.items) {
+        historyItems << historyItem->clone(Entry::CloneNoFlags);
     }
+
     // We need to prevent any modification to the database since every change should be tracked either
     // in a clone history item or in the Entry itself
     const TimeInfo timeInfo = targetEntry->timeInfo();
     const bool blockedSignals = targetEntry->blockSignals(true);
     bool updateTimeInfo = targetEntry->canUpdateTimeinfo();
     targetEntry->setUpdateTimeinfo(false);
+    const auto targetHistoryItems = targetEntry->historyItems();
     targetEntry->removeHistoryItems(targetHistoryItems);
-    for (Entry* historyItem : merged) {
+    for (Entry* historyItem : historyItems) {
         Q_ASSERT(!historyItem->parent());
         targetEntry->addHistoryItem(historyItem);
     }
     targetEntry->truncateHistory();
+    targetEntry->shareHistoryData();
     targetEntry->blockSignals(blockedSignals);
     targetEntry->setUpdateTimeinfo(updateTimeInfo);
     Q_ASSERT(timeInfo == targetEntry->timeInfo());
     Q_UNUSED(timeInfo);
-    return true;
 }
 
 Merger::ChangeList Merger::mergeDeletions(const MergeContext& context)
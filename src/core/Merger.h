@@ -46,22 +46,36 @@ private:
         QPointer<const Group> m_sourceGroup;
         QPointer<Group> m_targetGroup;
     };
-    ChangeList mergeGroup(const MergeContext& context);
+    // History of an entry after merging, the items are owned by the source or the target database
+    struct HistoryMerge
+    {
+        QList<const Entry*> items;
+        bool changed = false;
+    };
+    // An entry present in both databases, planned concurrently and applied while merging its group
+    struct EntryMerge
+    {
+        const Entry* sourceEntry;
+        Entry* targetEntry;
+        bool sourceIsNewer;
+        HistoryMerge history;
+    };
+    typedef QHash<const Entry*, EntryMerge> EntryMerges;
+    ChangeList mergeGroup(const MergeContext& context, const EntryMerges& entryMerges);
     ChangeList mergeDeletions(const MergeContext& context);
     ChangeList mergeMetadata(const MergeContext& context);
-    bool mergeHistory(const Entry* sourceEntry, Entry* targetEntry, Group::MergeMode mergeMethod, const int maxItems);
+    static EntryMerges planEntryMerges(const MergeContext& context);
+    static EntryMerge planEntryMerge(const Entry* sourceEntry, Entry* targetEntry, int maxItems);
+    static HistoryMerge planHistoryMerge(const Entry* sourceEntry, const Entry* targetEntry, int maxItems);
+    static void applyHistoryMerge(const HistoryMerge& history, Entry* targetEntry);
     void moveEntry(Entry* entry, Group* targetGroup);
     void moveGroup(Group* group, Group* targetGroup);
     // remove an entry without a trace in the deletedObjects - needed for elemination cloned entries
     void eraseEntry(Entry* entry);
     // remove an entry without a trace in the deletedObjects - needed for elemination cloned entries
     void eraseGroup(Group* group);
-    ChangeList resolveEntryConflict(const MergeContext& context, const Entry* existingEntry, Entry* otherEntry);
+    ChangeList resolveEntryConflict(const MergeContext& context, const EntryMerge& entryMerge);
     ChangeList resolveGroupConflict(const MergeContext& context, const Group* existingGroup, Group* otherGroup);
-    Merger::ChangeList resolveEntryConflict_MergeHistories(const MergeContext& context,
-                                                           const Entry* sourceEntry,
-                                                           Entry* targetEntry,
-                                                           Group::MergeMode mergeMethod);
 
 private:
     MergeContext m_context;
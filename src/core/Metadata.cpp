@@ -80,6 +80,7 @@ void Metadata::clear()
     m_customIconsOrder.clear();
     m_customIconsHashes.clear();
     m_customData->clear();
+    emit customIconsChanged();
 }
 
 template <class P, class V> bool Metadata::set(P& property, const V& value)
@@ -384,6 +385,7 @@ void Metadata::addCustomIcon(const QUuid& uuid, const CustomIconData& iconData)
     m_customIconsHashes[hash] = uuid;
     Q_ASSERT(m_customIcons.count() == m_customIconsOrder.count());
 
+    emit customIconsChanged();
     emitModified();
 }
 
@@ -410,6 +412,7 @@ void Metadata::removeCustomIcon(const QUuid& uuid)
     m_customIconsOrder.removeAll(uuid);
     Q_ASSERT(m_customIcons.count() == m_customIconsOrder.count());
     dynamic_cast<Database*>(parent())->addDeletedObject(uuid);
+    emit customIconsChanged();
     emitModified();
 }
 
@@ -167,6 +167,9 @@ public:
      */
     void copyAttributesFrom(const Metadata* other);
 
+signals:
+    void customIconsChanged();
+
 private:
     template <class P, class V> bool set(P& property, const V& value);
     template <class P, class V> bool set(P& property, const V& value, QDateTime& dateTime);
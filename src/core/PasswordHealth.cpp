@@ -19,6 +19,7 @@
 
 #include "Group.h"
 #include "PasswordHealth.h"
+#include "PasswordHealthCache.h"
 #include "zxcvbn.h"
 
 namespace
@@ -114,6 +115,7 @@ PasswordHealth::Quality PasswordHealth::quality() const
  * than can be derived from the password itself (re-use, expiry).
  */
 HealthChecker::HealthChecker(QSharedPointer<Database> db)
+    : m_db(db)
 {
     // Build the cache of re-used passwords
     for (const auto* entry : db->rootGroup()->entriesRecursive()) {
@@ -139,7 +141,7 @@ QSharedPointer<PasswordHealth> HealthChecker::evaluate(const Entry* entry) const
 
     // First analyse the password itself
     const auto pwd = entry->password();
-    auto health = QSharedPointer<PasswordHealth>(new PasswordHealth(pwd));
+    auto health = m_db->passwordHealthCache()->health(pwd);
 
     // Second, if the password is in the database more than once,
     // reduce the score accordingly
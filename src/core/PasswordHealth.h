@@ -111,6 +111,8 @@ public:
     QSharedPointer<PasswordHealth> evaluate(const Entry* entry) const;
 
 private:
+    // Shares password entropy estimates with the entries of the database
+    QSharedPointer<Database> m_db;
     // To determine password re-use: first = password, second = entries that use it
     QHash<QString, QStringList> m_reuse;
 };
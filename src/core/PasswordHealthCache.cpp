@@ -0,0 +1,166 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PasswordHealthCache.h"
+
+#include "core/PasswordHealth.h"
+#include "crypto/CryptoHash.h"
+#include "crypto/Random.h"
+
+#include <QThread>
+#include <QtConcurrent>
+
+#include <botan/mem_ops.h>
+
+namespace
+{
+    const int SecretSize = 32;
+} // namespace
+
+PasswordHealthCache::PasswordHealthCache()
+    : m_cancelled(0)
+{
+}
+
+PasswordHealthCache::~PasswordHealthCache()
+{
+    cancelPrecomputation();
+
+    QMutexLocker locker(&m_mutex);
+    wipeSecret();
+}
+
+/**
+ * Key of a password in the cache, must be called with the mutex locked.
+ */
+QByteArray PasswordHealthCache::cacheKey(const QString& password)
+{
+    if (m_secret.isEmpty()) {
+        m_secret = randomGen()->randomArray(SecretSize);
+    }
+    return CryptoHash::hmac(password.toUtf8(), m_secret, CryptoHash::Sha256);
+}
+
+/**
+ * Overwrite the HMAC secret, must be called with the mutex locked. A new one is created on next use.
+ */
+void PasswordHealthCache::wipeSecret()
+{
+    if (!m_secret.isEmpty()) {
+        Botan::secure_scrub_memory(m_secret.data(), static_cast<size_t>(m_secret.size()));
+        m_secret.clear();
+    }
+}
+
+/**
+ * Get the health of a password, based on its entropy alone.
+ * The returned object is not shared and may be adjusted by the caller.
+ */
+QSharedPointer<PasswordHealth> PasswordHealthCache::health(const QString& password)
+{
+    return QSharedPointer<PasswordHealth>::create(entropy(password));
+}
+
+bool PasswordHealthCache::contains(const QString& password)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entropies.contains(cacheKey(password));
+}
+
+double PasswordHealthCache::entropy(const QString& password)
+{
+    QByteArray key;
+    {
+        QMutexLocker locker(&m_mutex);
+        key = cacheKey(password);
+        auto it = m_entropies.constFind(key);
+        if (it != m_entropies.constEnd()) {
+            return it.value();
+        }
+    }
+
+    // Estimate outside of the lock, racing threads at worst compute the same value twice
+    const auto entropy = PasswordHealth(password).entropy();
+
+    QMutexLocker locker(&m_mutex);
+    m_entropies.insert(key, entropy);
+    return entropy;
+}
+
+/**
+ * Estimate the given passwords on the global thread pool.
+ * Passwords that are already cached are skipped.
+ *
+ * @param passwords passwords to estimate
+ */
+void PasswordHealthCache::precompute(const QStringList& passwords)
+{
+    for (auto it = m_futures.begin(); it != m_futures.end();) {
+        it = it->isFinished() ? m_futures.erase(it) : it + 1;
+    }
+
+    QStringList pending;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const auto& password : passwords) {
+            if (!m_entropies.contains(cacheKey(password))) {
+                pending << password;
+            }
+        }
+    }
+    if (pending.isEmpty()) {
+        return;
+    }
+
+    const int batchCount = qBound(1, QThread::idealThreadCount(), pending.size());
+    const int batchSize = (pending.size() + batchCount - 1) / batchCount;
+    for (int i = 0; i < pending.size(); i += batchSize) {
+        const auto batch = pending.mid(i, batchSize);
+        m_futures << QtConcurrent::run([this, batch] {
+            for (const auto& password : batch) {
+                if (m_cancelled.loadAcquire()) {
+                    return;
+                }
+                entropy(password);
+            }
+        });
+    }
+}
+
+void PasswordHealthCache::waitForPrecomputation()
+{
+    for (auto& future : m_futures) {
+        future.waitForFinished();
+    }
+    m_futures.clear();
+}
+
+void PasswordHealthCache::cancelPrecomputation()
+{
+    m_cancelled.storeRelease(1);
+    waitForPrecomputation();
+    m_cancelled.storeRelease(0);
+}
+
+void PasswordHealthCache::clear()
+{
+    cancelPrecomputation();
+
+    QMutexLocker locker(&m_mutex);
+    m_entropies.clear();
+    wipeSecret();
+}
@@ -0,0 +1,66 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_PASSWORDHEALTHCACHE_H
+#define KEEPASSX_PASSWORDHEALTHCACHE_H
+
+#include <QAtomicInt>
+#include <QFuture>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSharedPointer>
+
+class PasswordHealth;
+
+/**
+ * Cache of password entropy estimates, keyed by an HMAC of the password.
+ *
+ * Estimating the entropy of a password is expensive, so the estimates of a
+ * database are shared by the entry model, the health check and the database
+ * statistics. A changed password simply hashes to a different key. The HMAC
+ * secret is random and wiped by clear(), so the keys cannot be used to guess
+ * passwords once the database is locked. The cache can be filled ahead of time
+ * on the global thread pool. All methods are thread-safe.
+ */
+class PasswordHealthCache
+{
+public:
+    PasswordHealthCache();
+    ~PasswordHealthCache();
+
+    QSharedPointer<PasswordHealth> health(const QString& password);
+    bool contains(const QString& password);
+
+    void precompute(const QStringList& passwords);
+    void waitForPrecomputation();
+    void clear();
+
+private:
+    double entropy(const QString& password);
+    void cancelPrecomputation();
+    QByteArray cacheKey(const QString& password);
+    void wipeSecret();
+
+    QMutex m_mutex;
+    QByteArray m_secret;
+    QHash<QByteArray, double> m_entropies;
+    QList<QFuture<void>> m_futures;
+    QAtomicInt m_cancelled;
+};
+
+#endif // KEEPASSX_PASSWORDHEALTHCACHE_H
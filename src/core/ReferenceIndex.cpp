@@ -0,0 +1,183 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ReferenceIndex.h"
+
+#include "core/Database.h"
+#include "core/Group.h"
+#include "core/Tools.h"
+
+#include <botan/mem_ops.h>
+
+namespace
+{
+    const int UuidHexLength = 32;
+
+    /**
+     * Resolved values may contain passwords, overwrite every value that is not shared
+     * with anyone else before it is released.
+     */
+    template <typename Key> void wipeValues(QHash<Key, QString>& values)
+    {
+        for (auto it = values.begin(); it != values.end(); ++it) {
+            QString& value = it.value();
+            if (value.isDetached()) {
+                Botan::secure_scrub_memory(value.data(), static_cast<size_t>(value.size()) * sizeof(QChar));
+            }
+        }
+        values.clear();
+    }
+
+    bool isHexDigit(QChar c)
+    {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+    }
+
+    /**
+     * Collect every UUID whose hex form occurs in the given reference, this matches
+     * the case-insensitive substring test of Entry::isAttributeReferenceOf().
+     */
+    void collectReferencedUuids(const QString& reference, QList<QUuid>& uuids)
+    {
+        int runStart = 0;
+        for (int i = 0; i <= reference.size(); ++i) {
+            if (i < reference.size() && isHexDigit(reference.at(i))) {
+                continue;
+            }
+            for (int start = runStart; start + UuidHexLength <= i; ++start) {
+                uuids.append(Tools::hexToUuid(reference.mid(start, UuidHexLength)));
+            }
+            runStart = i + 1;
+        }
+    }
+} // namespace
+
+ReferenceIndex::ReferenceIndex(const Database* db)
+    : m_db(db)
+    , m_built(false)
+{
+    Q_ASSERT(db);
+}
+
+void ReferenceIndex::invalidate()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_built) {
+        for (auto& values : m_fieldValues) {
+            values.clear();
+        }
+        m_referencedBy.clear();
+        m_built = false;
+    }
+    wipeValues(m_resolvedValues[0]);
+    wipeValues(m_resolvedValues[1]);
+}
+
+/**
+ * Find the first entry in tree order whose field matches the given term exactly.
+ *
+ * @param term field value to look for
+ * @param referenceType field to compare, must not be QUuid or Unknown
+ * @return matching entry or nullptr
+ */
+Entry* ReferenceIndex::findEntry(const QString& term, EntryReferenceType referenceType)
+{
+    Q_ASSERT(referenceType != EntryReferenceType::QUuid);
+    if (referenceType == EntryReferenceType::Unknown || referenceType == EntryReferenceType::QUuid) {
+        return nullptr;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    build();
+    return m_fieldValues[static_cast<int>(referenceType)].value(term);
+}
+
+/**
+ * @param uuid UUID of the referenced entry
+ * @return entries with a standard field referencing the given UUID, in tree order
+ */
+QList<Entry*> ReferenceIndex::referencingEntries(const QUuid& uuid)
+{
+    QMutexLocker locker(&m_mutex);
+    build();
+    return m_referencedBy.value(uuid);
+}
+
+bool ReferenceIndex::resolvedValue(const Entry* entry, const QString& str, bool multiple, QString& result)
+{
+    QMutexLocker locker(&m_mutex);
+
+    const auto& values = m_resolvedValues[multiple ? 1 : 0];
+    auto it = values.constFind(qMakePair(entry, str));
+    if (it == values.constEnd()) {
+        return false;
+    }
+    result = it.value();
+    return true;
+}
+
+void ReferenceIndex::setResolvedValue(const Entry* entry, const QString& str, bool multiple, const QString& result)
+{
+    QMutexLocker locker(&m_mutex);
+    m_resolvedValues[multiple ? 1 : 0].insert(qMakePair(entry, str), result);
+}
+
+void ReferenceIndex::build()
+{
+    if (m_built) {
+        return;
+    }
+
+    auto insertFirst = [this](EntryReferenceType type, const QString& value, Entry* entry) {
+        auto& values = m_fieldValues[static_cast<int>(type)];
+        if (!values.contains(value)) {
+            values.insert(value, entry);
+        }
+    };
+
+    QList<QUuid> uuids;
+    for (const auto group : m_db->rootGroup()->groupsRecursive(true)) {
+        for (auto entry : group->entries()) {
+            insertFirst(EntryReferenceType::Title, entry->title(), entry);
+            insertFirst(EntryReferenceType::UserName, entry->username(), entry);
+            insertFirst(EntryReferenceType::Password, entry->password(), entry);
+            insertFirst(EntryReferenceType::Url, entry->url(), entry);
+            insertFirst(EntryReferenceType::Notes, entry->notes(), entry);
+
+            const auto attributes = entry->attributes();
+            for (const auto& key : attributes->keys()) {
+                insertFirst(EntryReferenceType::CustomAttributes, attributes->value(key), entry);
+            }
+
+            uuids.clear();
+            for (const auto& key : EntryAttributes::DefaultAttributes) {
+                if (attributes->isReference(key)) {
+                    collectReferencedUuids(attributes->value(key), uuids);
+                }
+            }
+            for (const auto& uuid : asConst(uuids)) {
+                auto& referencing = m_referencedBy[uuid];
+                if (referencing.isEmpty() || referencing.last() != entry) {
+                    referencing.append(entry);
+                }
+            }
+        }
+    }
+
+    m_built = true;
+}
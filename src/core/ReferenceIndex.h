@@ -0,0 +1,65 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_REFERENCEINDEX_H
+#define KEEPASSX_REFERENCEINDEX_H
+
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+
+#include "core/Entry.h"
+
+class Database;
+
+/**
+ * Lookup tables for resolving field references within a database.
+ *
+ * Maps field values to the first entry holding them, in tree order, and entry
+ * UUIDs to the entries referencing them. Also memoizes resolved placeholder
+ * values. Everything is built lazily on first use and dropped by invalidate()
+ * whenever the database changes or is locked, wiping the resolved values.
+ * All methods are thread-safe so placeholders can be resolved from concurrent
+ * searches.
+ */
+class ReferenceIndex
+{
+public:
+    explicit ReferenceIndex(const Database* db);
+
+    void invalidate();
+
+    Entry* findEntry(const QString& term, EntryReferenceType referenceType);
+    QList<Entry*> referencingEntries(const QUuid& uuid);
+
+    bool resolvedValue(const Entry* entry, const QString& str, bool multiple, QString& result);
+    void setResolvedValue(const Entry* entry, const QString& str, bool multiple, const QString& result);
+
+private:
+    void build();
+
+    static const int FieldCount = static_cast<int>(EntryReferenceType::CustomAttributes) + 1;
+
+    const Database* const m_db;
+    QMutex m_mutex;
+    bool m_built;
+    QHash<QString, Entry*> m_fieldValues[FieldCount];
+    QHash<QUuid, QList<Entry*>> m_referencedBy;
+    QHash<QPair<const Entry*, QString>, QString> m_resolvedValues[2];
+};
+
+#endif // KEEPASSX_REFERENCEINDEX_H
@@ -0,0 +1,186 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SearchIndex.h"
+
+#include "core/Entry.h"
+#include "core/Global.h"
+
+#include <algorithm>
+
+namespace
+{
+    void collectTrigrams(const QString& text, QVector<quint64>& trigrams)
+    {
+        if (text.size() < 3) {
+            return;
+        }
+
+        const QString folded = text.toCaseFolded();
+        const QChar* data = folded.constData();
+        for (int i = 0; i + 2 < folded.size(); ++i) {
+            trigrams.append((static_cast<quint64>(data[i].unicode()) << 32)
+                            | (static_cast<quint64>(data[i + 1].unicode()) << 16) | data[i + 2].unicode());
+        }
+    }
+
+    bool containsPlaceholder(const QString& text)
+    {
+        return text.contains('{');
+    }
+} // namespace
+
+SearchIndex::SearchIndex(QObject* parent)
+    : QObject(parent)
+{
+}
+
+void SearchIndex::addEntry(Entry* entry)
+{
+    Q_ASSERT(entry);
+
+    connect(entry, &Entry::modified, this, [this, entry] { markDirty(entry); });
+    markDirty(entry);
+}
+
+void SearchIndex::removeEntry(Entry* entry)
+{
+    Q_ASSERT(entry);
+
+    disconnect(entry, nullptr, this, nullptr);
+    m_dirty.remove(entry);
+    unindexEntry(entry);
+}
+
+/**
+ * Re-index all entries that have been added or modified since the last update.
+ */
+void SearchIndex::update()
+{
+    for (auto entry : asConst(m_dirty)) {
+        unindexEntry(entry);
+        indexEntry(entry);
+    }
+    m_dirty.clear();
+}
+
+/**
+ * Find all entries that may contain every one of the given text fragments.
+ *
+ * Fragments shorter than three characters do not narrow down the result. Entries
+ * whose title, username or URL contain placeholders are always returned since
+ * their resolved values are not known to the index.
+ *
+ * @param fragments literal text fragments, all of which must occur in a matching entry
+ * @param result set of candidate entries
+ * @return false if the fragments cannot be used to narrow down the search
+ */
+bool SearchIndex::candidates(const QStringList& fragments, QSet<const Entry*>& result)
+{
+    QVector<quint64> trigrams;
+    for (const auto& fragment : fragments) {
+        collectTrigrams(fragment, trigrams);
+    }
+    if (trigrams.isEmpty()) {
+        return false;
+    }
+
+    update();
+
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+    QList<const QSet<const Entry*>*> postings;
+    for (auto trigram : asConst(trigrams)) {
+        auto it = m_postings.constFind(trigram);
+        if (it == m_postings.constEnd()) {
+            result = m_unindexable;
+            return true;
+        }
+        postings.append(&it.value());
+    }
+
+    // Intersect starting with the smallest posting list
+    std::sort(postings.begin(), postings.end(), [](const QSet<const Entry*>* lhs, const QSet<const Entry*>* rhs) {
+        return lhs->size() < rhs->size();
+    });
+
+    result = *postings.first();
+    for (int i = 1; i < postings.size() && !result.isEmpty(); ++i) {
+        result.intersect(*postings.at(i));
+    }
+    result.unite(m_unindexable);
+
+    return true;
+}
+
+void SearchIndex::markDirty(Entry* entry)
+{
+    m_dirty.insert(entry);
+}
+
+void SearchIndex::indexEntry(const Entry* entry)
+{
+    const QString title = entry->title();
+    const QString username = entry->username();
+    const QString url = entry->url();
+
+    // Searches match the resolved values of these fields which cannot be indexed
+    if (containsPlaceholder(title) || containsPlaceholder(username) || containsPlaceholder(url)) {
+        m_unindexable.insert(entry);
+        return;
+    }
+
+    QVector<quint64> trigrams;
+    collectTrigrams(title, trigrams);
+    collectTrigrams(username, trigrams);
+    collectTrigrams(url, trigrams);
+    collectTrigrams(entry->notes(), trigrams);
+    for (const auto& tag : entry->tagList()) {
+        collectTrigrams(tag, trigrams);
+    }
+
+    const auto attributes = entry->attributes();
+    for (const auto& key : attributes->customKeys()) {
+        collectTrigrams(key, trigrams);
+        collectTrigrams(attributes->value(key), trigrams);
+    }
+
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+    for (auto trigram : asConst(trigrams)) {
+        m_postings[trigram].insert(entry);
+    }
+    m_entryTrigrams.insert(entry, trigrams);
+}
+
+void SearchIndex::unindexEntry(const Entry* entry)
+{
+    m_unindexable.remove(entry);
+
+    const auto trigrams = m_entryTrigrams.take(entry);
+    for (auto trigram : trigrams) {
+        auto it = m_postings.find(trigram);
+        if (it != m_postings.end()) {
+            it->remove(entry);
+            if (it->isEmpty()) {
+                m_postings.erase(it);
+            }
+        }
+    }
+}
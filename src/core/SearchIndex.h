@@ -0,0 +1,60 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_SEARCHINDEX_H
+#define KEEPASSX_SEARCHINDEX_H
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QVector>
+
+class Entry;
+
+/**
+ * Case-insensitive trigram index over the searchable fields of the entries of a database.
+ *
+ * The index covers title, username, URL, notes, tags and custom attribute keys and values.
+ * It is only used to narrow down the entries a search has to look at: every entry that
+ * may contain the requested text is returned, the caller still has to verify the match.
+ * Entries are re-indexed lazily on the next query after they have been modified.
+ */
+class SearchIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SearchIndex(QObject* parent = nullptr);
+
+    void addEntry(Entry* entry);
+    void removeEntry(Entry* entry);
+    void update();
+
+    bool candidates(const QStringList& fragments, QSet<const Entry*>& result);
+
+private:
+    void markDirty(Entry* entry);
+    void indexEntry(const Entry* entry);
+    void unindexEntry(const Entry* entry);
+
+    QHash<quint64, QSet<const Entry*>> m_postings;
+    QHash<const Entry*, QVector<quint64>> m_entryTrigrams;
+    QSet<const Entry*> m_unindexable;
+    QSet<Entry*> m_dirty;
+};
+
+#endif // KEEPASSX_SEARCHINDEX_H
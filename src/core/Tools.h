@@ -114,6 +114,25 @@ namespace Tools
         return missingValues;
     }
 
+    /**
+     * Let equal values of two associative containers share their data, so that the first
+     * container only holds copies of the values that differ from the second one.
+     * The content of both containers is unchanged.
+     */
+    template <typename Map> void shareEqualValues(Map& map, const Map& other)
+    {
+        if (map == other) {
+            map = other;
+            return;
+        }
+        for (auto it = map.begin(); it != map.end(); ++it) {
+            auto otherIt = other.constFind(it.key());
+            if (otherIt != other.constEnd() && it.value() == otherIt.value()) {
+                it.value() = otherIt.value();
+            }
+        }
+    }
+
     QVariantMap qo2qvm(const QObject* object, const QStringList& ignoredProperties = {"objectName"});
 
     QString substituteBackupFilePath(QString pattern, const QString& databasePath);
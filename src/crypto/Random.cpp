@@ -33,6 +33,16 @@ QSharedPointer<Random> Random::instance()
     return m_instance;
 }
 
+void Random::resetInstance()
+{
+    m_instance.reset();
+}
+
+void Random::setInstance(Random* random)
+{
+    m_instance = QSharedPointer<Random>(random);
+}
+
 Random::Random()
 {
 #ifdef BOTAN_HAS_SYSTEM_RNG
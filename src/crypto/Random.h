@@ -27,7 +27,9 @@ class Random
 public:
     static QSharedPointer<Random> instance();
 
-    void randomize(QByteArray& ba);
+    virtual ~Random() = default;
+
+    virtual void randomize(QByteArray& ba);
     QByteArray randomArray(int len);
 
     /**
@@ -42,8 +44,13 @@ public:
 
     QSharedPointer<Botan::RandomNumberGenerator> getRng();
 
-private:
+protected:
     explicit Random();
+
+    static void resetInstance();
+    static void setInstance(Random* random);
+
+private:
     Q_DISABLE_COPY(Random);
 
     static QSharedPointer<Random> m_instance;
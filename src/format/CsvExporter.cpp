@@ -18,38 +18,59 @@
 
 #include "CsvExporter.h"
 
-#include <QFile>
+#include <QBuffer>
+#include <QSaveFile>
 
 #include "core/Group.h"
 
+namespace
+{
+    const int BufferSize = 64 * 1024;
+} // namespace
+
 bool CsvExporter::exportDatabase(const QString& filename, const QSharedPointer<const Database>& db)
 {
-    QFile file(filename);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    // The export is written in chunks, a failed export must not leave a partial file behind
+    QSaveFile file(filename);
+    if (!file.open(QIODevice::WriteOnly)) {
+        m_error = file.errorString();
+        return false;
+    }
+    if (!exportDatabase(&file, db)) {
+        return false;
+    }
+    if (!file.commit()) {
         m_error = file.errorString();
         return false;
     }
-    return exportDatabase(&file, db);
+    return true;
 }
 
+/**
+ * Write the database to the device while it is traversed, the export is never held in memory
+ * as a whole.
+ */
 bool CsvExporter::exportDatabase(QIODevice* device, const QSharedPointer<const Database>& db)
 {
-    if (device->write(exportHeader().toUtf8()) == -1) {
-        m_error = device->errorString();
-        return false;
-    }
+    m_buffer.clear();
+    m_buffer.reserve(BufferSize + 1024);
+    m_line.reserve(1024);
 
-    if (device->write(exportGroup(db->rootGroup()).toUtf8()) == -1) {
-        m_error = device->errorString();
-        return false;
-    }
+    exportHeader();
+    const bool success = exportGroup(device, db->rootGroup()) && flush(device);
 
-    return true;
+    m_buffer.clear();
+    m_buffer.squeeze();
+    m_line.clear();
+    return success;
 }
 
 QString CsvExporter::exportDatabase(const QSharedPointer<const Database>& db)
 {
-    return exportHeader() + exportGroup(db->rootGroup());
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    exportDatabase(&buffer, db);
+    return QString::fromUtf8(buffer.data());
 }
 
 QString CsvExporter::errorString() const
@@ -57,25 +78,24 @@ QString CsvExporter::errorString() const
     return m_error;
 }
 
-QString CsvExporter::exportHeader()
+void CsvExporter::exportHeader()
 {
-    QString header;
-    addColumn(header, "Group");
-    addColumn(header, "Title");
-    addColumn(header, "Username");
-    addColumn(header, "Password");
-    addColumn(header, "URL");
-    addColumn(header, "Notes");
-    addColumn(header, "TOTP");
-    addColumn(header, "Icon");
-    addColumn(header, "Last Modified");
-    addColumn(header, "Created");
-    return header + QString("\n");
+    m_line.resize(0);
+    addColumn(m_line, "Group");
+    addColumn(m_line, "Title");
+    addColumn(m_line, "Username");
+    addColumn(m_line, "Password");
+    addColumn(m_line, "URL");
+    addColumn(m_line, "Notes");
+    addColumn(m_line, "TOTP");
+    addColumn(m_line, "Icon");
+    addColumn(m_line, "Last Modified");
+    addColumn(m_line, "Created");
+    addLine();
 }
 
-QString CsvExporter::exportGroup(const Group* group, QString groupPath)
+bool CsvExporter::exportGroup(QIODevice* device, const Group* group, QString groupPath)
 {
-    QString response;
     if (!groupPath.isEmpty()) {
         groupPath.append("/");
     }
@@ -83,29 +103,49 @@ QString CsvExporter::exportGroup(const Group* group, QString groupPath)
 
     const QList<Entry*>& entryList = group->entries();
     for (const Entry* entry : entryList) {
-        QString line;
-
-        addColumn(line, groupPath);
-        addColumn(line, entry->title());
-        addColumn(line, entry->username());
-        addColumn(line, entry->password());
-        addColumn(line, entry->url());
-        addColumn(line, entry->notes());
-        addColumn(line, entry->totpSettingsString());
-        addColumn(line, QString::number(entry->iconNumber()));
-        addColumn(line, entry->timeInfo().lastModificationTime().toString(Qt::ISODate));
-        addColumn(line, entry->timeInfo().creationTime().toString(Qt::ISODate));
-
-        line.append("\n");
-        response.append(line);
+        m_line.resize(0);
+
+        addColumn(m_line, groupPath);
+        addColumn(m_line, entry->title());
+        addColumn(m_line, entry->username());
+        addColumn(m_line, entry->password());
+        addColumn(m_line, entry->url());
+        addColumn(m_line, entry->notes());
+        addColumn(m_line, entry->totpSettingsString());
+        addColumn(m_line, QString::number(entry->iconNumber()));
+        addColumn(m_line, entry->timeInfo().lastModificationTime().toString(Qt::ISODate));
+        addColumn(m_line, entry->timeInfo().creationTime().toString(Qt::ISODate));
+
+        addLine();
+        if (m_buffer.size() >= BufferSize && !flush(device)) {
+            return false;
+        }
     }
 
     const QList<Group*>& children = group->children();
     for (const Group* child : children) {
-        response.append(exportGroup(child, groupPath));
+        if (!exportGroup(device, child, groupPath)) {
+            return false;
+        }
     }
 
-    return response;
+    return true;
+}
+
+void CsvExporter::addLine()
+{
+    m_line.append("\n");
+    m_buffer.append(m_line.toUtf8());
+}
+
+bool CsvExporter::flush(QIODevice* device)
+{
+    if (device->write(m_buffer) == -1) {
+        m_error = device->errorString();
+        return false;
+    }
+    m_buffer.resize(0);
+    return true;
 }
 
 void CsvExporter::addColumn(QString& str, const QString& column)
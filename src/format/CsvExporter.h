@@ -35,11 +35,16 @@ public:
     QString errorString() const;
 
 private:
-    QString exportGroup(const Group* group, QString groupPath = QString());
-    QString exportHeader();
+    bool exportGroup(QIODevice* device, const Group* group, QString groupPath = QString());
+    void exportHeader();
+    void addLine();
     void addColumn(QString& str, const QString& column);
+    bool flush(QIODevice* device);
 
     QString m_error;
+    // Lines are collected in the buffer and written in chunks, the line is reused for every entry
+    QByteArray m_buffer;
+    QString m_line;
 };
 
 #endif // KEEPASSX_CSVEXPORTER_H
@@ -21,10 +21,22 @@
 #include <QFile>
 #include <QTextCodec>
 
-#include "core/Tools.h"
+namespace
+{
+    // The file is decoded in chunks of this size, only the record being parsed is kept in memory
+    const int ChunkSize = 64 * 1024;
+} // namespace
 
 CsvParser::CsvParser()
-    : m_ch(0)
+    : m_pos(0)
+    , m_lastPos(-1)
+    , m_device(nullptr)
+    , m_codec(QTextCodec::codecForName("UTF-8"))
+    , m_skipLineFeed(false)
+    , m_fileSize(0)
+    , m_rowLimit(0)
+    , m_totalRows(0)
+    , m_ch(0)
     , m_comment('#')
     , m_currCol(1)
     , m_currRow(1)
@@ -32,22 +44,14 @@ CsvParser::CsvParser()
     , m_isEof(false)
     , m_isFileLoaded(false)
     , m_isGood(true)
-    , m_lastPos(-1)
     , m_maxCols(0)
     , m_qualifier('"')
     , m_separator(',')
     , m_statusMsg("")
 {
-    m_csv.setBuffer(&m_array);
-    m_ts.setDevice(&m_csv);
-    m_csv.open(QIODevice::ReadOnly);
-    m_ts.setCodec("UTF-8");
 }
 
-CsvParser::~CsvParser()
-{
-    m_csv.close();
-}
+CsvParser::~CsvParser() = default;
 
 bool CsvParser::isFileLoaded()
 {
@@ -57,7 +61,15 @@ bool CsvParser::isFileLoaded()
 bool CsvParser::reparse()
 {
     reset();
-    return parseFile();
+    if (!m_isFileLoaded) {
+        return parseFile();
+    }
+
+    QFile file(m_filename);
+    if (!openFile(&file)) {
+        return false;
+    }
+    return parseDevice(&file);
 }
 
 bool CsvParser::parse(QFile* device)
@@ -67,28 +79,33 @@ bool CsvParser::parse(QFile* device)
         appendStatusMsg(QObject::tr("NULL device"), true);
         return false;
     }
-    if (!readFile(device)) {
+    if (!openFile(device)) {
         return false;
     }
-    return parseFile();
+    m_filename = device->fileName();
+    return parseDevice(device);
 }
 
-bool CsvParser::readFile(QFile* device)
+bool CsvParser::parse(QFile* device, const std::function<void(const CsvRow&)>& rowHandler)
+{
+    m_rowHandler = rowHandler;
+    bool result = parse(device);
+    m_rowHandler = nullptr;
+    return result;
+}
+
+bool CsvParser::openFile(QFile* device)
 {
     if (device->isOpen()) {
         device->close();
     }
 
-    device->open(QIODevice::ReadOnly);
-    if (!Tools::readAllFromDevice(device, m_array)) {
+    if (!device->open(QIODevice::ReadOnly)) {
         appendStatusMsg(QObject::tr("error reading from device"), true);
         m_isFileLoaded = false;
     } else {
-        device->close();
-
-        m_array.replace("\r\n", "\n");
-        m_array.replace("\r", "\n");
-        if (m_array.isEmpty()) {
+        m_fileSize = device->size();
+        if (m_fileSize == 0) {
             appendStatusMsg(QObject::tr("file empty").append("\n"));
         }
         m_isFileLoaded = true;
@@ -96,6 +113,74 @@ bool CsvParser::readFile(QFile* device)
     return m_isFileLoaded;
 }
 
+bool CsvParser::parseDevice(QIODevice* device)
+{
+    m_device = device;
+    bool result = parseFile();
+    m_device = nullptr;
+    device->close();
+    return result;
+}
+
+/**
+ * Decode the next chunk of the device and append it to the text, line breaks are normalized
+ * to a single line feed.
+ *
+ * @return false if there is nothing left to read
+ */
+bool CsvParser::readChunk()
+{
+    if (!m_device) {
+        return false;
+    }
+
+    QByteArray data(ChunkSize, Qt::Uninitialized);
+    const qint64 bytesRead = m_device->read(data.data(), ChunkSize);
+    if (bytesRead < 0) {
+        // the file is incomplete, it does not count as loaded
+        appendStatusMsg(QObject::tr("error reading from device"), true);
+        m_isFileLoaded = false;
+        m_device = nullptr;
+        return false;
+    } else if (bytesRead == 0) {
+        return false;
+    }
+    data.resize(static_cast<int>(bytesRead));
+
+    if (!m_decoder) {
+        // honor a byte order mark like QTextStream does
+        m_decoder.reset(QTextCodec::codecForUtfText(data, m_codec)->makeDecoder());
+    }
+
+    const QString text = m_decoder->toUnicode(data);
+    m_text.reserve(m_text.size() + text.size());
+    for (const QChar c : text) {
+        if (c == '\r') {
+            m_text.append('\n');
+            m_skipLineFeed = true;
+        } else {
+            if (c != '\n' || !m_skipLineFeed) {
+                m_text.append(c);
+            }
+            m_skipLineFeed = false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Drop the text of the records parsed so far, nothing before the current position is
+ * looked at again.
+ */
+void CsvParser::discardParsed()
+{
+    if (m_pos >= ChunkSize) {
+        m_text.remove(0, m_pos);
+        m_lastPos -= m_pos;
+        m_pos = 0;
+    }
+}
+
 void CsvParser::reset()
 {
     m_ch = 0;
@@ -105,8 +190,12 @@ void CsvParser::reset()
     m_isGood = true;
     m_lastPos = -1;
     m_maxCols = 0;
+    m_totalRows = 0;
     m_statusMsg = "";
-    m_ts.seek(0);
+    m_text.clear();
+    m_pos = 0;
+    m_decoder.reset();
+    m_skipLineFeed = false;
     m_table.clear();
     // the following are users' concern :)
     // m_comment = '#';
@@ -120,7 +209,8 @@ void CsvParser::clear()
 {
     reset();
     m_isFileLoaded = false;
-    m_array.clear();
+    m_filename.clear();
+    m_fileSize = 0;
 }
 
 bool CsvParser::parseFile()
@@ -132,9 +222,14 @@ bool CsvParser::parseFile()
         }
         m_currRow++;
         m_currCol = 1;
+        discardParsed();
         parseRecord();
     }
     fillColumns();
+    // the text is only needed while parsing
+    m_text = QString();
+    m_pos = 0;
+    m_lastPos = -1;
     return m_isGood;
 }
 
@@ -157,13 +252,23 @@ void CsvParser::parseRecord()
         row.clear();
         return;
     }
-    m_table.push_back(row);
+    appendRow(row);
     if (m_maxCols < row.size()) {
         m_maxCols = row.size();
     }
     m_currCol++;
 }
 
+void CsvParser::appendRow(const CsvRow& row)
+{
+    ++m_totalRows;
+    if (m_rowHandler) {
+        m_rowHandler(row);
+    } else if (m_rowLimit <= 0 || m_table.size() < m_rowLimit) {
+        m_table.push_back(row);
+    }
+}
+
 void CsvParser::parseField(CsvRow& row)
 {
     QString field;
@@ -275,8 +380,14 @@ void CsvParser::fillColumns()
 
 void CsvParser::skipLine()
 {
-    m_ts.readLine();
-    m_ts.seek(m_ts.pos() - 1);
+    // stop in front of the line feed, it is consumed by skipEndline()
+    QChar c;
+    do {
+        getChar(c);
+    } while (!isCRLF(c) && !m_isEof);
+    if (!m_isEof) {
+        ungetChar();
+    }
 }
 
 bool CsvParser::skipEndline()
@@ -287,19 +398,25 @@ bool CsvParser::skipEndline()
 
 void CsvParser::getChar(QChar& c)
 {
-    m_isEof = m_ts.atEnd();
-    if (!m_isEof) {
-        m_lastPos = m_ts.pos();
-        m_ts >> c;
+    while (m_pos >= m_text.size()) {
+        if (!readChunk()) {
+            m_isEof = true;
+            return;
+        }
     }
+    m_isEof = false;
+    m_lastPos = m_pos;
+    c = m_text.at(m_pos++);
 }
 
 void CsvParser::ungetChar()
 {
-    if (!m_ts.seek(m_lastPos)) {
+    if (m_lastPos < 0) {
         qWarning("CSV Parser: unget lower bound exceeded");
         m_isGood = false;
+        return;
     }
+    m_pos = m_lastPos;
 }
 
 void CsvParser::peek(QChar& c)
@@ -323,7 +440,7 @@ bool CsvParser::isComment()
 {
     bool result = false;
     QChar c2;
-    qint64 pos = m_ts.pos();
+    int pos = m_pos;
 
     do {
         getChar(c2);
@@ -332,7 +449,7 @@ bool CsvParser::isComment()
     if (c2 == m_comment) {
         result = true;
     }
-    m_ts.seek(pos);
+    m_pos = pos;
     return result;
 }
 
@@ -389,7 +506,8 @@ void CsvParser::setComment(const QChar& c)
 
 void CsvParser::setCodec(const QString& s)
 {
-    m_ts.setCodec(QTextCodec::codecForName(s.toLocal8Bit()));
+    auto codec = QTextCodec::codecForName(s.toLocal8Bit());
+    m_codec = codec ? codec : QTextCodec::codecForName("UTF-8");
 }
 
 void CsvParser::setFieldSeparator(const QChar& c)
@@ -402,9 +520,14 @@ void CsvParser::setTextQualifier(const QChar& c)
     m_qualifier = c.unicode();
 }
 
+void CsvParser::setRowLimit(int rows)
+{
+    m_rowLimit = rows;
+}
+
 int CsvParser::getFileSize() const
 {
-    return m_csv.size();
+    return static_cast<int>(m_fileSize);
 }
 
 const CsvTable CsvParser::getCsvTable() const
@@ -431,6 +554,11 @@ int CsvParser::getCsvRows() const
     return m_table.size();
 }
 
+int CsvParser::getTotalRows() const
+{
+    return m_totalRows;
+}
+
 void CsvParser::appendStatusMsg(const QString& s, bool isCritical)
 {
     m_statusMsg += QObject::tr("%1: (row, col) %2,%3").arg(s, m_currRow, m_currCol).append("\n");
@@ -19,10 +19,15 @@
 #ifndef KEEPASSX_CSVPARSER_H
 #define KEEPASSX_CSVPARSER_H
 
-#include <QBuffer>
-#include <QTextStream>
+#include <QScopedPointer>
+#include <QStringList>
+
+#include <functional>
 
 class QFile;
+class QIODevice;
+class QTextCodec;
+class QTextDecoder;
 
 typedef QStringList CsvRow;
 typedef QList<CsvRow> CsvTable;
@@ -35,16 +40,21 @@ public:
     ~CsvParser();
     // read data from device and parse it
     bool parse(QFile* device);
+    // parse the device without storing the table, every row is passed to the handler
+    bool parse(QFile* device, const std::function<void(const CsvRow&)>& rowHandler);
     bool isFileLoaded();
-    // reparse the same buffer (device is not opened again)
+    // reparse the same file (the device is read again chunk by chunk)
     bool reparse();
     void setCodec(const QString& s);
     void setComment(const QChar& c);
     void setFieldSeparator(const QChar& c);
     void setTextQualifier(const QChar& c);
     void setBackslashSyntax(bool set);
+    // keep at most the given number of rows in the table, 0 keeps all rows
+    void setRowLimit(int rows);
     int getFileSize() const;
     int getCsvRows() const;
+    int getTotalRows() const;
     int getCsvCols() const;
     QString getStatus() const;
     const CsvTable getCsvTable() const;
@@ -53,8 +63,20 @@ protected:
     CsvTable m_table;
 
 private:
-    QByteArray m_array;
-    QBuffer m_csv;
+    // decoded text of the current record and what has been read ahead of it
+    QString m_text;
+    int m_pos;
+    int m_lastPos;
+    QIODevice* m_device;
+    QTextCodec* m_codec;
+    QScopedPointer<QTextDecoder> m_decoder;
+    bool m_skipLineFeed;
+    QString m_filename;
+    qint64 m_fileSize;
+    std::function<void(const CsvRow&)> m_rowHandler;
+    int m_rowLimit;
+    int m_totalRows;
+
     QChar m_ch;
     QChar m_comment;
     unsigned int m_currCol;
@@ -63,12 +85,10 @@ private:
     bool m_isEof;
     bool m_isFileLoaded;
     bool m_isGood;
-    qint64 m_lastPos;
     int m_maxCols;
     QChar m_qualifier;
     QChar m_separator;
     QString m_statusMsg;
-    QTextStream m_ts;
 
     void getChar(QChar& c);
     void ungetChar();
@@ -85,13 +105,17 @@ private:
     bool isTab(const QChar& c) const;
     bool isEmptyRow(const CsvRow& row) const;
     bool parseFile();
+    bool parseDevice(QIODevice* device);
     void parseRecord();
     void parseField(CsvRow& row);
     void parseSimple(QString& s);
     void parseQuoted(QString& s);
     void parseEscaped(QString& s);
     void parseEscapedText(QString& s);
-    bool readFile(QFile* device);
+    bool openFile(QFile* device);
+    bool readChunk();
+    void discardParsed();
+    void appendRow(const CsvRow& row);
     void reset();
     void clear();
     bool skipEndline();
@@ -19,6 +19,7 @@
 
 #include <QBuffer>
 #include <QJsonObject>
+#include <QThread>
 
 #include "core/AsyncTask.h"
 #include "core/Endian.h"
@@ -27,10 +28,59 @@
 #include "format/KdbxXmlReader.h"
 #include "format/KeePass2RandomStream.h"
 #include "streams/HmacBlockStream.h"
+#include "streams/PipelineStream.h"
 #include "streams/StoreDataStream.h"
 #include "streams/SymmetricCipherStream.h"
 #include "streams/qtiocompressor.h"
 
+namespace
+{
+    // Payloads smaller than this are decoded faster than the pipeline threads can be started
+    const qint64 PipelineMinPayloadSize = 1024 * 1024;
+
+    /**
+     * Insert a pipeline stage on top of the given device if pipelining is enabled.
+     *
+     * @param device device to read from in the pipeline worker thread
+     * @param stage pipeline stage storage
+     * @param pipelined false to pass the device through unchanged
+     * @return device to use for the next layer or nullptr on error
+     */
+    QIODevice* addPipelineStage(QIODevice* device, QScopedPointer<PipelineStream>& stage, bool pipelined)
+    {
+        if (!pipelined) {
+            return device;
+        }
+        stage.reset(new PipelineStream(device));
+        if (!stage->open(QIODevice::ReadOnly)) {
+            return nullptr;
+        }
+        return stage.data();
+    }
+} // namespace
+
+Kdbx4Reader::Kdbx4Reader()
+    : m_pipelined(QThread::idealThreadCount() > 1)
+{
+}
+
+/**
+ * Decode the payload with one worker thread per stream layer (HMAC verification, decryption
+ * and decompression) running concurrently with the XML parser. Only used for payloads of at
+ * least 1 MiB. Enabled by default on systems with more than one core.
+ *
+ * @param pipelined true to decode the payload in a multi-threaded pipeline
+ */
+void Kdbx4Reader::setPipelined(bool pipelined)
+{
+    m_pipelined = pipelined;
+}
+
+bool Kdbx4Reader::isPipelined() const
+{
+    return m_pipelined;
+}
+
 bool Kdbx4Reader::readDatabaseImpl(QIODevice* device,
                                    const QByteArray& headerData,
                                    QSharedPointer<const CompositeKey> key,
@@ -85,12 +135,22 @@ bool Kdbx4Reader::readDatabaseImpl(QIODevice* device,
         return false;
     }
 
+    // Pipeline stages are declared after the layer they read from so they are stopped before it is destroyed
+    bool pipelined = m_pipelined && !device->isSequential()
+                     && (device->size() - device->pos()) >= PipelineMinPayloadSize;
+    QScopedPointer<PipelineStream> hmacStage;
+    QIODevice* cipherInput = addPipelineStage(&hmacStream, hmacStage, pipelined);
+    if (!cipherInput) {
+        raiseError(tr("Unable to start payload pipeline"));
+        return false;
+    }
+
     auto mode = SymmetricCipher::cipherUuidToMode(db->cipher());
     if (mode == SymmetricCipher::InvalidMode) {
         raiseError(tr("Unknown cipher"));
         return false;
     }
-    SymmetricCipherStream cipherStream(&hmacStream);
+    SymmetricCipherStream cipherStream(cipherInput);
     if (!cipherStream.init(mode, SymmetricCipher::Decrypt, finalKey, m_encryptionIV)) {
         raiseError(cipherStream.errorString());
         return false;
@@ -101,19 +161,26 @@ bool Kdbx4Reader::readDatabaseImpl(QIODevice* device,
     }
     // clang-format on
 
-    QIODevice* xmlDevice = nullptr;
+    QScopedPointer<PipelineStream> cipherStage;
+    QIODevice* xmlDevice = addPipelineStage(&cipherStream, cipherStage, pipelined);
     QScopedPointer<QtIOCompressor> ioCompressor;
+    QScopedPointer<PipelineStream> compressorStage;
 
-    if (db->compressionAlgorithm() == Database::CompressionNone) {
-        xmlDevice = &cipherStream;
-    } else {
-        ioCompressor.reset(new QtIOCompressor(&cipherStream));
+    if (!xmlDevice) {
+        raiseError(tr("Unable to start payload pipeline"));
+        return false;
+    } else if (db->compressionAlgorithm() != Database::CompressionNone) {
+        ioCompressor.reset(new QtIOCompressor(xmlDevice));
         ioCompressor->setStreamFormat(QtIOCompressor::GzipFormat);
         if (!ioCompressor->open(QIODevice::ReadOnly)) {
             raiseError(ioCompressor->errorString());
             return false;
         }
-        xmlDevice = ioCompressor.data();
+        xmlDevice = addPipelineStage(ioCompressor.data(), compressorStage, pipelined);
+        if (!xmlDevice) {
+            raiseError(tr("Unable to start payload pipeline"));
+            return false;
+        }
     }
 
     while (readInnerHeaderField(xmlDevice) && !hasError()) {
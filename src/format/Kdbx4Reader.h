@@ -28,6 +28,11 @@ class Kdbx4Reader : public KdbxReader
     Q_DECLARE_TR_FUNCTIONS(Kdbx4Reader)
 
 public:
+    Kdbx4Reader();
+
+    void setPipelined(bool pipelined);
+    bool isPipelined() const;
+
     bool readDatabaseImpl(QIODevice* device,
                           const QByteArray& headerData,
                           QSharedPointer<const CompositeKey> key,
@@ -42,6 +47,7 @@ private:
     QVariantMap readVariantMap(QIODevice* device);
 
     QHash<QString, QByteArray> m_binaryPool;
+    bool m_pipelined;
 };
 
 #endif // KEEPASSX_KDBX4READER_H
@@ -18,15 +18,70 @@
 #include "Kdbx4Writer.h"
 
 #include <QBuffer>
+#include <QThread>
 
 #include "crypto/CryptoHash.h"
 #include "crypto/Random.h"
 #include "format/KdbxXmlWriter.h"
 #include "format/KeePass2RandomStream.h"
 #include "streams/HmacBlockStream.h"
+#include "streams/PipelineStream.h"
 #include "streams/SymmetricCipherStream.h"
 #include "streams/qtiocompressor.h"
 
+namespace
+{
+    /**
+     * Insert a pipeline stage in front of the given device if pipelining is enabled.
+     *
+     * @param device device to write to in the pipeline worker thread
+     * @param stage pipeline stage storage
+     * @param pipelined false to pass the device through unchanged
+     * @return device to use for the previous layer or nullptr on error
+     */
+    QIODevice* addPipelineStage(QIODevice* device, QScopedPointer<PipelineStream>& stage, bool pipelined)
+    {
+        if (!pipelined) {
+            return device;
+        }
+        stage.reset(new PipelineStream(device));
+        if (!stage->open(QIODevice::WriteOnly)) {
+            return nullptr;
+        }
+        return stage.data();
+    }
+
+    /**
+     * Wait until a pipeline stage has passed all data on to the next layer.
+     */
+    bool flushPipelineStage(const QScopedPointer<PipelineStream>& stage)
+    {
+        return !stage || stage->reset();
+    }
+} // namespace
+
+Kdbx4Writer::Kdbx4Writer()
+    : m_pipelined(QThread::idealThreadCount() > 1)
+{
+}
+
+/**
+ * Encode the payload with XML serialization, compression and encryption (including the
+ * HMAC blocks) running concurrently on separate threads. The output is the same as
+ * without pipelining. Enabled by default on systems with more than one core.
+ *
+ * @param pipelined true to encode the payload in a multi-threaded pipeline
+ */
+void Kdbx4Writer::setPipelined(bool pipelined)
+{
+    m_pipelined = pipelined;
+}
+
+bool Kdbx4Writer::isPipelined() const
+{
+    return m_pipelined;
+}
+
 bool Kdbx4Writer::writeDatabase(QIODevice* device, Database* db)
 {
     m_error = false;
@@ -131,19 +186,27 @@ bool Kdbx4Writer::writeDatabase(QIODevice* device, Database* db)
         return false;
     }
 
-    QIODevice* outputDevice = nullptr;
+    // Pipeline stages are declared after the layer they write to so they are flushed before it is destroyed
+    QScopedPointer<PipelineStream> cipherStage;
+    QIODevice* outputDevice = addPipelineStage(cipherStream.data(), cipherStage, m_pipelined);
     QScopedPointer<QtIOCompressor> ioCompressor;
+    QScopedPointer<PipelineStream> compressorStage;
 
-    if (db->compressionAlgorithm() == Database::CompressionNone) {
-        outputDevice = cipherStream.data();
-    } else {
-        ioCompressor.reset(new QtIOCompressor(cipherStream.data()));
+    if (!outputDevice) {
+        raiseError(tr("Unable to start payload pipeline"));
+        return false;
+    } else if (db->compressionAlgorithm() != Database::CompressionNone) {
+        ioCompressor.reset(new QtIOCompressor(outputDevice));
         ioCompressor->setStreamFormat(QtIOCompressor::GzipFormat);
         if (!ioCompressor->open(QIODevice::WriteOnly)) {
             raiseError(ioCompressor->errorString());
             return false;
         }
-        outputDevice = ioCompressor.data();
+        outputDevice = addPipelineStage(ioCompressor.data(), compressorStage, m_pipelined);
+        if (!outputDevice) {
+            raiseError(tr("Unable to start payload pipeline"));
+            return false;
+        }
     }
 
     Q_ASSERT(outputDevice);
@@ -171,9 +234,17 @@ bool Kdbx4Writer::writeDatabase(QIODevice* device, Database* db)
 
     // Explicitly close/reset streams so they are flushed and we can detect
     // errors. QIODevice::close() resets errorString() etc.
+    if (!flushPipelineStage(compressorStage)) {
+        raiseError(compressorStage->errorString());
+        return false;
+    }
     if (ioCompressor) {
         ioCompressor->close();
     }
+    if (!flushPipelineStage(cipherStage)) {
+        raiseError(cipherStage->errorString());
+        return false;
+    }
     if (!cipherStream->reset()) {
         raiseError(cipherStream->errorString());
         return false;
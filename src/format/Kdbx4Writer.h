@@ -28,12 +28,19 @@ class Kdbx4Writer : public KdbxWriter
     Q_DECLARE_TR_FUNCTIONS(Kdbx4Writer)
 
 public:
+    Kdbx4Writer();
+
+    void setPipelined(bool pipelined);
+    bool isPipelined() const;
+
     bool writeDatabase(QIODevice* device, Database* db) override;
 
 private:
     bool writeInnerHeaderField(QIODevice* device, KeePass2::InnerHeaderFieldID fieldId, const QByteArray& data);
     void writeAttachments(QIODevice* device, Database* db);
     static bool serializeVariantMap(const QVariantMap& map, QByteArray& outputBytes);
+
+    bool m_pipelined;
 };
 
 #endif // KEEPASSX_KDBX4WRITER_H
@@ -71,9 +71,23 @@ void KdbxWriter::extractDatabase(QByteArray& xmlOutput, Database* db)
     QBuffer buffer;
     buffer.setBuffer(&xmlOutput);
     buffer.open(QIODevice::WriteOnly);
+    extractDatabase(&buffer, db);
+}
+
+/**
+ * Write the unencrypted XML of a database to a device as it is generated.
+ *
+ * @param device output device
+ * @param db source database
+ */
+void KdbxWriter::extractDatabase(QIODevice* device, Database* db)
+{
     KdbxXmlWriter writer(db->formatVersion());
     writer.disableInnerStreamProtection(true);
-    writer.writeDatabase(&buffer, db);
+    writer.writeDatabase(device, db);
+    if (writer.hasError()) {
+        raiseError(writer.errorString());
+    }
 }
 
 /**
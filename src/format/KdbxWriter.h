@@ -53,6 +53,7 @@ public:
     virtual bool writeDatabase(QIODevice* device, Database* db) = 0;
 
     void extractDatabase(QByteArray& xmlOutput, Database* db);
+    void extractDatabase(QIODevice* device, Database* db);
 
     bool hasError() const;
     QString errorString() const;
@@ -28,6 +28,75 @@
 
 #define UUID_LENGTH 16
 
+namespace
+{
+    /**
+     * Incremental base64 decoder writing into a growing destination buffer.
+     *
+     * Like QByteArray::fromBase64(), characters outside of the base64 alphabet are
+     * skipped, which covers padding and line breaks.
+     */
+    class Base64Decoder
+    {
+    public:
+        explicit Base64Decoder(QByteArray& output)
+            : m_output(output)
+        {
+        }
+
+        void decode(const QStringRef& text)
+        {
+            const int required = m_size + text.size() / 4 * 3 + 3;
+            if (m_output.size() < required) {
+                m_output.resize(required);
+            }
+
+            char* out = m_output.data() + m_size;
+            for (const QChar c : text) {
+                const int value = valueOf(c.unicode());
+                if (value < 0) {
+                    continue;
+                }
+                m_buffer = (m_buffer << 6) | static_cast<quint32>(value);
+                m_bits += 6;
+                if (m_bits >= 8) {
+                    m_bits -= 8;
+                    *out++ = static_cast<char>(m_buffer >> m_bits);
+                    m_buffer &= (1u << m_bits) - 1;
+                }
+            }
+            m_size = static_cast<int>(out - m_output.constData());
+        }
+
+        int size() const
+        {
+            return m_size;
+        }
+
+    private:
+        static int valueOf(ushort c)
+        {
+            if (c >= 'A' && c <= 'Z') {
+                return c - 'A';
+            } else if (c >= 'a' && c <= 'z') {
+                return c - 'a' + 26;
+            } else if (c >= '0' && c <= '9') {
+                return c - '0' + 52;
+            } else if (c == '+') {
+                return 62;
+            } else if (c == '/') {
+                return 63;
+            }
+            return -1;
+        }
+
+        QByteArray& m_output;
+        int m_size = 0;
+        quint32 m_buffer = 0;
+        int m_bits = 0;
+    };
+} // namespace
+
 /**
  * @param version KDBX version
  */
@@ -149,6 +218,9 @@ void KdbxXmlReader::readDatabase(QIODevice* device, Database* db, KeePass2Random
     QHash<QUuid, Entry*>::const_iterator iEntry;
     for (iEntry = m_entries.constBegin(); iEntry != m_entries.constEnd(); ++iEntry) {
         iEntry.value()->setUpdateTimeinfo(true);
+        // Every history item is parsed into its own values, share the unchanged ones
+        // now that the binary references are resolved into attachments
+        iEntry.value()->shareHistoryData();
 
         const QList<Entry*> historyItems = iEntry.value()->historyItems();
         for (Entry* histEntry : historyItems) {
@@ -186,6 +258,51 @@ QString KdbxXmlReader::errorString() const
     return {};
 }
 
+/**
+ * Pass the text of the current element to the handler as it is parsed, without
+ * collecting it into a string first. The text is only valid during the call.
+ *
+ * @return false if the element contains anything but text
+ */
+template <typename TextHandler> bool KdbxXmlReader::readElementChunks(TextHandler handleText)
+{
+    Q_ASSERT(m_xml.isStartElement());
+
+    while (!m_xml.atEnd()) {
+        switch (m_xml.readNext()) {
+        case QXmlStreamReader::Characters:
+        case QXmlStreamReader::EntityReference:
+            handleText(m_xml.text());
+            break;
+        case QXmlStreamReader::Comment:
+        case QXmlStreamReader::ProcessingInstruction:
+            break;
+        case QXmlStreamReader::EndElement:
+            return true;
+        default:
+            m_xml.raiseError(tr("Expected character data."));
+            return false;
+        }
+    }
+
+    return false;
+}
+
+QString KdbxXmlReader::internString(const QStringRef& text)
+{
+    const uint hash = qHash(text);
+    auto it = m_internedStrings.constFind(hash);
+    if (it != m_internedStrings.constEnd() && it.value() == text) {
+        return it.value();
+    }
+
+    QString string = text.toString();
+    if (it == m_internedStrings.constEnd()) {
+        m_internedStrings.insert(hash, string);
+    }
+    return string;
+}
+
 bool KdbxXmlReader::isTrueValue(const QStringRef& value)
 {
     return value.compare(QLatin1String("true"), Qt::CaseInsensitive) == 0 || value == "1";
@@ -426,7 +543,7 @@ void KdbxXmlReader::parseCustomDataItem(CustomData* customData)
 
     while (!m_xml.hasError() && m_xml.readNextStartElement()) {
         if (m_xml.name() == "Key") {
-            key = readString();
+            key = readKey();
             keySet = true;
         } else if (m_xml.name() == "Value") {
             item.value = readString();
@@ -833,7 +950,7 @@ void KdbxXmlReader::parseEntryString(Entry* entry)
 
     while (!m_xml.hasError() && m_xml.readNextStartElement()) {
         if (m_xml.name() == "Key") {
-            key = readString();
+            key = readKey();
             keySet = true;
             continue;
         }
@@ -877,7 +994,7 @@ QPair<QString, QString> KdbxXmlReader::parseEntryBinary(Entry* entry)
 
     while (!m_xml.hasError() && m_xml.readNextStartElement()) {
         if (m_xml.name() == "Key") {
-            key = readString();
+            key = readKey();
             keySet = true;
             continue;
         }
@@ -1017,24 +1134,55 @@ QString KdbxXmlReader::readString(bool& isProtected, bool& protectInMemory)
     QXmlStreamAttributes attr = m_xml.attributes();
     isProtected = isTrueValue(attr.value("Protected"));
     protectInMemory = isTrueValue(attr.value("ProtectInMemory"));
-    QString value = m_xml.readElementText();
 
-    if (isProtected && !value.isEmpty()) {
-        QByteArray ciphertext = QByteArray::fromBase64(value.toLatin1());
-        bool ok;
-        QByteArray plaintext = m_randomStream->process(ciphertext, &ok);
-        if (!ok) {
-            value.clear();
-            raiseError(m_randomStream->errorString());
-            return value;
-        }
+    if (!isProtected) {
+        return m_xml.readElementText();
+    }
 
-        value = QString::fromUtf8(plaintext);
+    // Decode straight from the parser into the scratch buffer and decrypt it there
+    Base64Decoder decoder(m_scratch);
+    readElementChunks([&decoder](const QStringRef& text) { decoder.decode(text); });
+    const int size = decoder.size();
+    if (size == 0) {
+        return {};
+    }
+
+    QString value;
+    if (m_randomStream->processInPlace(m_scratch.data(), size)) {
+        value = QString::fromUtf8(m_scratch.constData(), size);
+    } else {
+        raiseError(m_randomStream->errorString());
     }
+    memset(m_scratch.data(), 0, static_cast<size_t>(size));
 
     return value;
 }
 
+/**
+ * Read an attribute or custom data key. Keys repeat across entries, so
+ * equal keys share their string data instead of allocating a copy each.
+ */
+QString KdbxXmlReader::readKey()
+{
+    QString key;
+    bool firstChunk = true;
+    bool multipleChunks = false;
+    readElementChunks([&](const QStringRef& text) {
+        if (firstChunk) {
+            key = internString(text);
+            firstChunk = false;
+        } else {
+            key.append(text);
+            multipleChunks = true;
+        }
+    });
+
+    if (multipleChunks) {
+        key = internString(QStringRef(&key));
+    }
+    return key;
+}
+
 bool KdbxXmlReader::readBool()
 {
     QString str = readString();
@@ -1132,19 +1280,15 @@ QByteArray KdbxXmlReader::readBinary()
 {
     QXmlStreamAttributes attr = m_xml.attributes();
     bool isProtected = isTrueValue(attr.value("Protected"));
-    QString value = m_xml.readElementText();
-    QByteArray data = QByteArray::fromBase64(value.toLatin1());
 
-    if (isProtected && !data.isEmpty()) {
-        bool ok;
-        QByteArray plaintext = m_randomStream->process(data, &ok);
-        if (!ok) {
-            data.clear();
-            raiseError(m_randomStream->errorString());
-            return data;
-        }
+    QByteArray data;
+    Base64Decoder decoder(data);
+    readElementChunks([&decoder](const QStringRef& text) { decoder.decode(text); });
+    data.resize(decoder.size());
 
-        data = plaintext;
+    if (isProtected && !data.isEmpty() && !m_randomStream->processInPlace(data)) {
+        data.clear();
+        raiseError(m_randomStream->errorString());
     }
 
     return data;
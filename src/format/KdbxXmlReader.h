@@ -79,6 +79,7 @@ protected:
 
     virtual QString readString();
     virtual QString readString(bool& isProtected, bool& protectInMemory);
+    virtual QString readKey();
     virtual bool readBool();
     virtual QDateTime readDateTime();
     virtual QString readColor();
@@ -95,6 +96,9 @@ protected:
     virtual bool isTrueValue(const QStringRef& value);
     virtual void raiseError(const QString& errorMessage);
 
+    template <typename TextHandler> bool readElementChunks(TextHandler handleText);
+    QString internString(const QStringRef& text);
+
     const quint32 m_kdbxVersion;
 
     bool m_strictMode = false;
@@ -112,6 +116,10 @@ protected:
     QHash<QString, QPair<Entry*, QString>> m_binaryMap;
     QByteArray m_headerHash;
 
+    // Reused for decoding protected values, wiped after every use
+    QByteArray m_scratch;
+    QHash<uint, QString> m_internedStrings;
+
     bool m_error = false;
     QString m_errorStr = "";
 };
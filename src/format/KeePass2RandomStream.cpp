@@ -42,22 +42,10 @@ bool KeePass2RandomStream::init(SymmetricCipher::Mode mode, const QByteArray& ke
 
 QByteArray KeePass2RandomStream::randomBytes(int size, bool* ok)
 {
-    QByteArray result;
-
-    int bytesRemaining = size;
-
-    while (bytesRemaining > 0) {
-        if (m_buffer.size() == m_offset) {
-            if (!loadBlock()) {
-                *ok = false;
-                return {};
-            }
-        }
-
-        int bytesToCopy = qMin(bytesRemaining, m_buffer.size() - m_offset);
-        result.append(m_buffer.mid(m_offset, bytesToCopy));
-        m_offset += bytesToCopy;
-        bytesRemaining -= bytesToCopy;
+    QByteArray result(size, '\0');
+    if (!processInPlace(result.data(), result.size())) {
+        *ok = false;
+        return {};
     }
 
     *ok = true;
@@ -66,54 +54,38 @@ QByteArray KeePass2RandomStream::randomBytes(int size, bool* ok)
 
 QByteArray KeePass2RandomStream::process(const QByteArray& data, bool* ok)
 {
-    bool randomBytesOk;
-
-    QByteArray randomData = randomBytes(data.size(), &randomBytesOk);
-    if (!randomBytesOk) {
+    QByteArray result(data);
+    if (!processInPlace(result)) {
         *ok = false;
         return {};
     }
 
-    QByteArray result;
-    result.resize(data.size());
-
-    for (int i = 0; i < data.size(); i++) {
-        result[i] = data[i] ^ randomData[i];
-    }
-
     *ok = true;
     return result;
 }
 
 bool KeePass2RandomStream::processInPlace(QByteArray& data)
 {
-    bool ok;
-    QByteArray randomData = randomBytes(data.size(), &ok);
-    if (!ok) {
-        return false;
-    }
+    return processInPlace(data.data(), data.size());
+}
 
-    for (int i = 0; i < data.size(); i++) {
-        data[i] = data[i] ^ randomData[i];
+/**
+ * XOR the next bytes of the key stream into the given buffer.
+ *
+ * The stream cipher generates the key stream in large blocks and XORs it into the
+ * buffer word by word, so no intermediate key stream buffer is needed.
+ */
+bool KeePass2RandomStream::processInPlace(char* data, int size)
+{
+    // The cipher rejects empty input, but there is nothing to do anyway
+    if (size == 0) {
+        return true;
     }
 
-    return true;
+    return m_cipher.process(data, size);
 }
 
 QString KeePass2RandomStream::errorString() const
 {
     return m_cipher.errorString();
 }
-
-bool KeePass2RandomStream::loadBlock()
-{
-    Q_ASSERT(m_offset == m_buffer.size());
-
-    m_buffer.fill('\0', m_cipher.blockSize(m_cipher.mode()));
-    if (!m_cipher.process(m_buffer)) {
-        return false;
-    }
-    m_offset = 0;
-
-    return true;
-}
@@ -29,14 +29,11 @@ public:
     QByteArray randomBytes(int size, bool* ok);
     QByteArray process(const QByteArray& data, bool* ok);
     Q_REQUIRED_RESULT bool processInPlace(QByteArray& data);
+    Q_REQUIRED_RESULT bool processInPlace(char* data, int size);
     QString errorString() const;
 
 private:
-    bool loadBlock();
-
     SymmetricCipher m_cipher;
-    QByteArray m_buffer;
-    int m_offset = 0;
 };
 
 #endif // KEEPASSX_KEEPASS2RANDOMSTREAM_H
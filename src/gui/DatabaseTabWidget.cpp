@@ -18,6 +18,7 @@
 #include "DatabaseTabWidget.h"
 
 #include <QFileInfo>
+#include <QSaveFile>
 #include <QTabBar>
 
 #include "autotype/AutoType.h"
@@ -515,18 +516,23 @@ void DatabaseTabWidget::exportToXML()
 
     FileDialog::saveLastDir("xml", fileName, true);
 
-    QByteArray xmlData;
+    // Nothing is left behind if the export fails halfway
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        emit messageGlobal(tr("Writing the XML file failed").append("\n").append(file.errorString()),
+                           MessageWidget::Error);
+        return;
+    }
+
     QString err;
-    if (!db->extract(xmlData, &err)) {
+    if (!db->extract(&file, &err)) {
         emit messageGlobal(tr("Writing the XML file failed").append("\n").append(err), MessageWidget::Error);
+        return;
     }
-
-    QFile file(fileName);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    if (!file.commit()) {
         emit messageGlobal(tr("Writing the XML file failed").append("\n").append(file.errorString()),
                            MessageWidget::Error);
     }
-    file.write(xmlData);
 }
 
 bool DatabaseTabWidget::warnOnExport()
@@ -33,6 +33,7 @@
 #include <core/Tools.h>
 
 #include "autotype/AutoType.h"
+#include "core/DatabaseDiff.h"
 #include "core/EntrySearcher.h"
 #include "core/Merger.h"
 #include "gui/Clipboard.h"
@@ -233,6 +234,11 @@ DatabaseWidget::DatabaseWidget(QSharedPointer<Database> db, QWidget* parent)
 
     m_searchLimitGroup = config()->get(Config::SearchLimitGroup).toBool();
 
+    m_searchTimer = new QTimer(this);
+    m_searchTimer->setSingleShot(true);
+    m_searchTimer->setInterval(0);
+    connect(m_searchTimer, SIGNAL(timeout()), this, SLOT(continueSearch()));
+
 #ifdef WITH_XC_KEESHARE
     // We need to reregister the database to allow exports
     // from a newly created database
@@ -1122,6 +1128,13 @@ void DatabaseWidget::connectDatabaseSignals()
     connect(m_db.data(), &Database::databaseFileChanged, this, &DatabaseWidget::reloadDatabaseFile);
     connect(m_db.data(), &Database::databaseNonDataChanged, this, &DatabaseWidget::databaseNonDataChanged);
     connect(m_db.data(), &Database::databaseNonDataChanged, this, &DatabaseWidget::onDatabaseNonDataChanged);
+
+    // Keep the transformed key for the next save ready so saving does not stall on the KDF
+    m_db->setKeyPrecomputationEnabled(true);
+    // Keep type-ahead search fast on large databases
+    m_db->setSearchIndexEnabled(true);
+    // Estimate password strength in the background so reports and statistics open instantly
+    m_db->setPasswordHealthPrecomputationEnabled(true);
 }
 
 void DatabaseWidget::loadDatabase(bool accepted)
@@ -1447,6 +1460,10 @@ void DatabaseWidget::refreshSearch()
         search(m_lastSearchText);
         // Re-select the previous entry if it is still in the search
         m_entryView->setCurrentEntry(selectedEntry);
+        if (m_searchTimer->isActive()) {
+            // The entry may only be found in a later chunk
+            m_searchSelection = selectedEntry;
+        }
     }
 }
 
@@ -1457,12 +1474,40 @@ void DatabaseWidget::search(const QString& searchtext)
         return;
     }
 
+    cancelSearch();
+
     auto searchGroup = m_db->rootGroup();
     if (m_searchLimitGroup && m_nextSearchLabelText.isEmpty()) {
         searchGroup = currentGroup();
     }
 
-    auto results = m_entrySearcher->search(searchtext, searchGroup);
+    auto entries = m_entrySearcher->collectEntries(searchtext, searchGroup);
+    if (entries.size() > SearchChunkSize) {
+        // Match large searches in chunks so typing is not blocked, results are streamed into the view
+        for (auto entry : asConst(entries)) {
+            m_searchQueue.append(entry);
+        }
+        m_searchTotal = entries.size();
+        m_searchResultCount = 0;
+
+        emit searchModeAboutToActivate();
+
+        m_entryView->displaySearch({});
+        m_lastSearchText = searchtext;
+
+        m_searchingLabel->setText(tr("Searching… %1%").arg(0));
+        m_searchingLabel->setVisible(true);
+#ifdef WITH_XC_KEESHARE
+        m_shareLabel->setVisible(false);
+#endif
+
+        emit searchModeActivated();
+
+        m_searchTimer->start();
+        return;
+    }
+
+    auto results = m_entrySearcher->filterEntries(entries);
 
     // Display a label detailing our search results
     if (!m_nextSearchLabelText.isEmpty()) {
@@ -1492,6 +1537,67 @@ void DatabaseWidget::search(const QString& searchtext)
     emit searchModeActivated();
 }
 
+void DatabaseWidget::continueSearch()
+{
+    if (!isSearchActive()) {
+        cancelSearch();
+        return;
+    }
+
+    QList<Entry*> chunk;
+    while (!m_searchQueue.isEmpty() && chunk.size() < SearchChunkSize) {
+        // Skip entries that were deleted in the meantime
+        auto entry = m_searchQueue.takeFirst();
+        if (entry) {
+            chunk.append(entry);
+        }
+    }
+
+    auto results = m_entrySearcher->filterEntries(chunk);
+    m_searchResultCount += results.size();
+    m_entryView->appendSearchResults(results);
+
+    if (m_searchSelection && results.contains(m_searchSelection)) {
+        m_entryView->setCurrentEntry(m_searchSelection);
+        m_searchSelection.clear();
+    }
+
+    if (m_searchQueue.isEmpty()) {
+        finishSearch();
+        return;
+    }
+
+    int progress = (m_searchTotal - m_searchQueue.size()) * 100 / m_searchTotal;
+    m_searchingLabel->setText(tr("Searching… %1%").arg(progress));
+    m_searchTimer->start();
+}
+
+void DatabaseWidget::finishSearch()
+{
+    m_searchSelection.clear();
+
+    if (!m_nextSearchLabelText.isEmpty()) {
+        // Custom searches don't display if there are no results
+        if (m_searchResultCount == 0) {
+            endSearch();
+            return;
+        }
+        m_searchingLabel->setText(m_nextSearchLabelText);
+        m_nextSearchLabelText.clear();
+    } else if (m_searchResultCount > 0) {
+        m_searchingLabel->setText(tr("Search Results (%1)").arg(m_searchResultCount));
+    } else {
+        m_searchingLabel->setText(tr("No Results"));
+    }
+}
+
+void DatabaseWidget::cancelSearch()
+{
+    m_searchTimer->stop();
+    m_searchQueue.clear();
+    m_searchSelection.clear();
+}
+
 void DatabaseWidget::saveSearch(const QString& searchtext)
 {
     if (!m_db->isInitialized()) {
@@ -1620,6 +1726,8 @@ QString DatabaseWidget::getCurrentSearch()
 
 void DatabaseWidget::endSearch()
 {
+    cancelSearch();
+
     if (isSearchActive()) {
         // Show the normal entry view of the current group
         emit listModeAboutToActivate();
@@ -1863,6 +1971,8 @@ void DatabaseWidget::reloadDatabaseFile()
 
     QString error;
     auto db = QSharedPointer<Database>::create(m_db->filePath());
+    // Skip the KDF if the file was written with the same KDF parameters and seed
+    db->setTransformedKeyCache(m_db.data());
     if (db->open(database()->key(), &error)) {
         if (m_db->isModified() || db->hasNonDataChanges()) {
             // Ask if we want to merge changes into new database
@@ -1880,19 +1990,25 @@ void DatabaseWidget::reloadDatabaseFile()
             }
         }
 
-        QUuid groupBeforeReload = m_db->rootGroup()->uuid();
-        if (m_groupView && m_groupView->currentGroup()) {
-            groupBeforeReload = m_groupView->currentGroup()->uuid();
-        }
+        // Apply only what changed to the open database, this keeps the views and their state intact
+        DatabaseDiff diff(db.data(), m_db.data());
+        if (diff.apply()) {
+            refreshSearch();
+        } else {
+            QUuid groupBeforeReload = m_db->rootGroup()->uuid();
+            if (m_groupView && m_groupView->currentGroup()) {
+                groupBeforeReload = m_groupView->currentGroup()->uuid();
+            }
 
-        QUuid entryBeforeReload;
-        if (m_entryView && m_entryView->currentEntry()) {
-            entryBeforeReload = m_entryView->currentEntry()->uuid();
-        }
+            QUuid entryBeforeReload;
+            if (m_entryView && m_entryView->currentEntry()) {
+                entryBeforeReload = m_entryView->currentEntry()->uuid();
+            }
 
-        replaceDatabase(db);
+            replaceDatabase(db);
+            restoreGroupEntryFocus(groupBeforeReload, entryBeforeReload);
+        }
         processAutoOpen();
-        restoreGroupEntryFocus(groupBeforeReload, entryBeforeReload);
         m_blockAutoSave = false;
     } else {
         showMessage(tr("Could not open the new database file while attempting to autoreload.\nError: %1").arg(error),
@@ -260,6 +260,7 @@ private slots:
     void onGroupChanged();
     void onDatabaseModified();
     void onDatabaseNonDataChanged();
+    void continueSearch();
     void onAutosaveDelayTimeout();
     void connectDatabaseSignals();
     void loadDatabase(bool accepted);
@@ -277,6 +278,8 @@ private:
     void openDatabaseFromEntry(const Entry* entry, bool inBackground = true);
     void performIconDownloads(const QList<Entry*>& entries, bool force = false, bool downloadInBackground = false);
     bool performSave(QString& errorMessage, const QString& fileName = {});
+    void cancelSearch();
+    void finishSearch();
 
     QSharedPointer<Database> m_db;
 
@@ -315,6 +318,13 @@ private:
     QString m_lastSearchText;
     QString m_nextSearchLabelText;
     bool m_searchLimitGroup;
+    // Pending entries of a search that is matched in chunks
+    static const int SearchChunkSize = 2000;
+    QList<QPointer<Entry>> m_searchQueue;
+    int m_searchTotal = 0;
+    int m_searchResultCount = 0;
+    QPointer<Entry> m_searchSelection;
+    QPointer<QTimer> m_searchTimer;
 
     // Autoreload
     bool m_blockAutoSave;
@@ -19,6 +19,7 @@
 
 #include <QBuffer>
 #include <QFile>
+#include <QtConcurrent>
 
 #include "core/Group.h"
 #include "core/Metadata.h"
@@ -26,17 +27,15 @@
 
 namespace
 {
-    QString PixmapToHTML(const QPixmap& pixmap)
+    // Number of groups that are formatted concurrently before they are written
+    const int GroupBatchSize = 64;
+
+    QString iconToHTML(int iconClass)
     {
-        if (pixmap.isNull()) {
+        if (iconClass < 0) {
             return "";
         }
-
-        // Based on https://stackoverflow.com/a/6621278
-        QByteArray a;
-        QBuffer buffer(&a);
-        pixmap.save(&buffer, "PNG");
-        return QString("<img src=\"data:image/png;base64,") + a.toBase64() + "\"/>";
+        return QString("<span class=\"icon icon%1\"></span>").arg(iconClass);
     }
 
     QString formatEntry(const Entry& entry)
@@ -138,6 +137,15 @@ bool HtmlExporter::exportDatabase(QIODevice* device,
         return false;
     }
 
+    // Icons are rendered on this thread while the groups are collected, the styles need all of them
+    m_sections.clear();
+    m_icons.clear();
+    m_iconClasses.clear();
+    m_entryIconClasses.clear();
+    if (db->rootGroup()) {
+        collectGroup(*db->rootGroup(), QString(), sorted, ascending);
+    }
+
     const auto header = QString("<html>"
                                 "<head>"
                                 "<meta charset=\"UTF-8\">"
@@ -162,7 +170,8 @@ bool HtmlExporter::exportDatabase(QIODevice* device,
                                   "{ font-size: larger; font-family: monospace; } "
                                   ".notes "
                                   "{ font-size: small; } "
-                                  "</style>"
+                                + iconStyles()
+                                + "</style>"
                                   "</head>\n"
                                   "<body>"
                                   "<h1>"
@@ -176,30 +185,41 @@ bool HtmlExporter::exportDatabase(QIODevice* device,
     const auto footer = QString("</body>"
                                 "</html>");
 
-    if (device->write(header.toUtf8()) == -1) {
-        m_error = device->errorString();
-        return false;
-    }
-
-    if (db->rootGroup()) {
-        if (!writeGroup(*device, *db->rootGroup(), QString(), sorted, ascending)) {
-            return false;
+    bool success = device->write(header.toUtf8()) != -1;
+
+    // Groups are formatted concurrently in batches and written in order, so only one batch is held in memory
+    for (int i = 0; success && i < m_sections.size(); i += GroupBatchSize) {
+        const auto batch = m_sections.mid(i, GroupBatchSize);
+        const auto formatted = QtConcurrent::blockingMapped<QList<QByteArray>>(
+            batch, [](const GroupSection& section) { return formatGroup(section); });
+        for (const auto& html : formatted) {
+            if (device->write(html) == -1) {
+                success = false;
+                break;
+            }
         }
     }
 
-    if (device->write(footer.toUtf8()) == -1) {
+    success = success && device->write(footer.toUtf8()) != -1;
+    if (!success) {
         m_error = device->errorString();
-        return false;
     }
 
-    return true;
+    m_sections.clear();
+    m_icons.clear();
+    m_iconClasses.clear();
+    m_entryIconClasses.clear();
+    return success;
 }
 
-bool HtmlExporter::writeGroup(QIODevice& device, const Group& group, QString path, bool sorted, bool ascending)
+/**
+ * Append the group and its children to the sections in output order and render their icons.
+ */
+void HtmlExporter::collectGroup(const Group& group, QString path, bool sorted, bool ascending)
 {
     // Don't output the recycle bin
     if (&group == group.database()->metadata()->recycleBin()) {
-        return true;
+        return;
     }
 
     if (!path.isEmpty()) {
@@ -207,34 +227,14 @@ bool HtmlExporter::writeGroup(QIODevice& device, const Group& group, QString pat
     }
     path.append(group.name().toHtmlEscaped());
 
+    GroupSection section;
+    section.group = &group;
+    section.path = path;
     // Output the header for this group (but only if there are
     // any notes or  entries in this group, otherwise we'd get
     // a header with nothing after it, which looks stupid)
-    const auto notes = group.notes();
-    if (!group.entries().empty() || !notes.isEmpty()) {
-        // Header line
-        auto header = QString("<hr><h2>");
-        header.append(PixmapToHTML(Icons::groupIconPixmap(&group, IconSize::Medium)));
-        header.append("&nbsp;");
-        header.append(path);
-        header.append("</h2>\n");
-
-        // Group notes
-        if (!notes.isEmpty()) {
-            header.append("<p>");
-            header.append(notes.toHtmlEscaped().replace("\n", "<br>"));
-            header.append("</p>");
-        }
-
-        // Output it
-        if (device.write(header.toUtf8()) == -1) {
-            m_error = device.errorString();
-            return false;
-        }
-    }
-
-    // Begin the table for the entries in this group
-    auto table = QString("<table width=\"95%\">");
+    section.hasHeader = !group.entries().empty() || !group.notes().isEmpty();
+    section.iconClass = section.hasHeader ? iconClass(Icons::groupIconPixmap(&group, IconSize::Medium)) : -1;
 
     auto entries = group.entries();
     if (sorted) {
@@ -243,32 +243,11 @@ bool HtmlExporter::writeGroup(QIODevice& device, const Group& group, QString pat
             return ascending ? cmp < 0 : cmp > 0;
         });
     }
-
-    // Output the entries in this group
     for (const auto* entry : entries) {
-        auto formatted_entry = formatEntry(*entry);
-
-        if (formatted_entry.isEmpty())
-            continue;
-
-        // Output it into our table. First the left side with
-        // icon and entry title ...
-        table += "<tr>";
-        table += "<td width=\"1%\">" + PixmapToHTML(Icons::entryIconPixmap(entry, IconSize::Medium)) + "</td>";
-        auto caption = "<caption>" + entry->title().toHtmlEscaped() + "</caption>";
-
-        // ... then the right side with the data fields
-        table +=
-            "<td style=\"padding-bottom: 0.5em;\"><table width=\"100%\">" + caption + formatted_entry + "</table></td>";
-        table += "</tr>";
-    }
-
-    // Output the complete table of this group
-    table.append("</table>\n");
-    if (device.write(table.toUtf8()) == -1) {
-        m_error = device.errorString();
-        return false;
+        section.entries.append(entry);
+        section.entryIconClasses.append(entryIconClass(*entry));
     }
+    m_sections.append(section);
 
     auto children = group.children();
     if (sorted) {
@@ -278,12 +257,115 @@ bool HtmlExporter::writeGroup(QIODevice& device, const Group& group, QString pat
         });
     }
 
-    // Recursively output the child groups
     for (const auto* child : children) {
-        if (child && !writeGroup(device, *child, path, sorted, ascending)) {
-            return false;
+        if (child) {
+            collectGroup(*child, path, sorted, ascending);
+        }
+    }
+}
+
+/**
+ * Entries that look the same share their icon class without rendering the icon again.
+ */
+int HtmlExporter::entryIconClass(const Entry& entry)
+{
+    auto key = entry.iconUuid().isNull() ? QString::number(entry.iconNumber()) : entry.iconUuid().toString();
+    if (entry.isExpired()) {
+        key.append("-expired");
+    }
+
+    auto it = m_entryIconClasses.constFind(key);
+    if (it != m_entryIconClasses.constEnd()) {
+        return it.value();
+    }
+
+    const int index = iconClass(Icons::entryIconPixmap(&entry, IconSize::Medium));
+    m_entryIconClasses.insert(key, index);
+    return index;
+}
+
+/**
+ * @return index of the CSS class showing the pixmap, -1 for a null pixmap
+ */
+int HtmlExporter::iconClass(const QPixmap& pixmap)
+{
+    if (pixmap.isNull()) {
+        return -1;
+    }
+
+    // Based on https://stackoverflow.com/a/6621278
+    QByteArray png;
+    QBuffer buffer(&png);
+    pixmap.save(&buffer, "PNG");
+
+    auto it = m_iconClasses.constFind(png);
+    if (it != m_iconClasses.constEnd()) {
+        return it.value();
+    }
+
+    const int index = m_icons.size();
+    m_icons.append(png.toBase64());
+    m_iconClasses.insert(png, index);
+    return index;
+}
+
+QString HtmlExporter::iconStyles() const
+{
+    // Generated content is printed, unlike background images
+    QString styles(".icon "
+                   "{ display: inline-block; vertical-align: middle; } ");
+    for (int i = 0; i < m_icons.size(); ++i) {
+        styles.append(QString(".icon%1::before { content: url(data:image/png;base64,").arg(i));
+        styles.append(QString::fromLatin1(m_icons.at(i)));
+        styles.append("); } ");
+    }
+    return styles;
+}
+
+QByteArray HtmlExporter::formatGroup(const GroupSection& section)
+{
+    QString html;
+
+    if (section.hasHeader) {
+        // Header line
+        html.append("<hr><h2>");
+        html.append(iconToHTML(section.iconClass));
+        html.append("&nbsp;");
+        html.append(section.path);
+        html.append("</h2>\n");
+
+        // Group notes
+        const auto notes = section.group->notes();
+        if (!notes.isEmpty()) {
+            html.append("<p>");
+            html.append(notes.toHtmlEscaped().replace("\n", "<br>"));
+            html.append("</p>");
         }
     }
 
-    return true;
+    // Begin the table for the entries in this group
+    html.append("<table width=\"95%\">");
+
+    // Output the entries in this group
+    for (int i = 0; i < section.entries.size(); ++i) {
+        const auto* entry = section.entries.at(i);
+        auto formatted_entry = formatEntry(*entry);
+
+        if (formatted_entry.isEmpty())
+            continue;
+
+        // Output it into our table. First the left side with
+        // icon and entry title ...
+        html += "<tr>";
+        html += "<td width=\"1%\">" + iconToHTML(section.entryIconClasses.at(i)) + "</td>";
+        auto caption = "<caption>" + entry->title().toHtmlEscaped() + "</caption>";
+
+        // ... then the right side with the data fields
+        html +=
+            "<td style=\"padding-bottom: 0.5em;\"><table width=\"100%\">" + caption + formatted_entry + "</table></td>";
+        html += "</tr>";
+    }
+
+    html.append("</table>\n");
+    return html.toUtf8();
 }
@@ -18,12 +18,15 @@
 #ifndef KEEPASSX_HTMLEXPORTER_H
 #define KEEPASSX_HTMLEXPORTER_H
 
+#include <QHash>
 #include <QSharedPointer>
 #include <QString>
 
 class Database;
+class Entry;
 class Group;
 class QIODevice;
+class QPixmap;
 
 class HtmlExporter
 {
@@ -35,17 +38,33 @@ public:
     QString errorString() const;
 
 private:
+    // A group in output order with everything needed to format it on a worker thread
+    struct GroupSection
+    {
+        const Group* group;
+        QString path;
+        bool hasHeader;
+        int iconClass;
+        QList<const Entry*> entries;
+        QList<int> entryIconClasses;
+    };
+
     bool exportDatabase(QIODevice* device,
                         const QSharedPointer<const Database>& db,
                         bool sorted = true,
                         bool ascending = true);
-    bool writeGroup(QIODevice& device,
-                    const Group& group,
-                    QString path = QString(),
-                    bool sorted = true,
-                    bool ascending = true);
+    void collectGroup(const Group& group, QString path, bool sorted, bool ascending);
+    int entryIconClass(const Entry& entry);
+    int iconClass(const QPixmap& pixmap);
+    QString iconStyles() const;
+    static QByteArray formatGroup(const GroupSection& section);
 
     QString m_error;
+    QList<GroupSection> m_sections;
+    // Every distinct icon is embedded once as a CSS class, the index in m_icons
+    QList<QByteArray> m_icons;
+    QHash<QByteArray, int> m_iconClasses;
+    QHash<QString, int> m_entryIconClasses;
 };
 
 #endif // KEEPASSX_HTMLEXPORTER_H
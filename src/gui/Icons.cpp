@@ -25,6 +25,7 @@
 
 #include "config-keepassx.h"
 #include "core/Config.h"
+#include "core/Metadata.h"
 #include "gui/DatabaseIcons.h"
 #include "gui/MainWindow.h"
 #include "gui/osutils/OSUtils.h"
@@ -218,13 +219,52 @@ Icons* Icons::instance()
 
 QPixmap Icons::customIconPixmap(const Database* db, const QUuid& uuid, IconSize size)
 {
-    if (!db->metadata()->hasCustomIcon(uuid)) {
+    return customIconPixmap(db, uuid, size, -1);
+}
+
+/**
+ * Decode and scale a custom icon, optionally with a badge applied.
+ * Results are cached until the custom icons of the database change.
+ *
+ * @param badge DatabaseIcons::Badges value or -1 for no badge
+ */
+QPixmap Icons::customIconPixmap(const Database* db, const QUuid& uuid, IconSize size, int badge)
+{
+    const auto* metadata = db->metadata();
+    if (!metadata->hasCustomIcon(uuid)) {
         return {};
     }
-    // Generate QIcon with pre-baked resolutions
-    auto icon = QImage::fromData(db->metadata()->customIcon(uuid).data);
-    auto basePixmap = QPixmap::fromImage(icon.scaled(64, 64, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
-    return QIcon(basePixmap).pixmap(databaseIcons()->iconSize(size));
+
+    auto& cacheByMetadata = instance()->m_customIconCache;
+    auto cache = cacheByMetadata.find(metadata);
+    if (cache == cacheByMetadata.end()) {
+        cache = cacheByMetadata.insert(metadata, {});
+        QObject::connect(metadata, &Metadata::customIconsChanged, metadata, [metadata] {
+            instance()->m_customIconCache[metadata].clear();
+        });
+        QObject::connect(metadata, &QObject::destroyed, [metadata] {
+            instance()->m_customIconCache.remove(metadata);
+        });
+    }
+
+    const QPair<QUuid, int> key(uuid, static_cast<int>(size) * 16 + badge + 1);
+    auto pixmap = cache->value(key);
+    if (!pixmap.isNull()) {
+        return pixmap;
+    }
+
+    if (badge >= 0) {
+        pixmap = databaseIcons()->applyBadge(customIconPixmap(db, uuid, size, -1),
+                                             static_cast<DatabaseIcons::Badges>(badge));
+    } else {
+        // Generate QIcon with pre-baked resolutions
+        auto icon = QImage::fromData(metadata->customIcon(uuid).data);
+        auto basePixmap = QPixmap::fromImage(icon.scaled(64, 64, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+        pixmap = QIcon(basePixmap).pixmap(databaseIcons()->iconSize(size));
+    }
+
+    cache->insert(key, pixmap);
+    return pixmap;
 }
 
 QHash<QUuid, QPixmap> Icons::customIconsPixmaps(const Database* db, IconSize size)
@@ -240,13 +280,14 @@ QHash<QUuid, QPixmap> Icons::customIconsPixmaps(const Database* db, IconSize siz
 
 QPixmap Icons::entryIconPixmap(const Entry* entry, IconSize size)
 {
+    if (!entry->iconUuid().isNull() && entry->database()) {
+        return Icons::customIconPixmap(
+            entry->database(), entry->iconUuid(), size, entry->isExpired() ? DatabaseIcons::Badges::Expired : -1);
+    }
+
     QPixmap icon(size, size);
     if (entry->iconUuid().isNull()) {
         icon = databaseIcons()->icon(entry->iconNumber(), size);
-    } else {
-        if (entry->database()) {
-            icon = Icons::customIconPixmap(entry->database(), entry->iconUuid(), size);
-        }
     }
 
     if (entry->isExpired()) {
@@ -258,13 +299,23 @@ QPixmap Icons::entryIconPixmap(const Entry* entry, IconSize size)
 
 QPixmap Icons::groupIconPixmap(const Group* group, IconSize size)
 {
+    if (!group->iconUuid().isNull() && group->database()) {
+        int badge = -1;
+        if (group->isExpired()) {
+            badge = DatabaseIcons::Badges::Expired;
+        }
+#ifdef WITH_XC_KEESHARE
+        else if (KeeShare::isShared(group)) {
+            badge = KeeShare::isEnabled(group) ? DatabaseIcons::Badges::ShareActive
+                                               : DatabaseIcons::Badges::ShareInactive;
+        }
+#endif
+        return Icons::customIconPixmap(group->database(), group->iconUuid(), size, badge);
+    }
+
     QPixmap icon(size, size);
     if (group->iconUuid().isNull()) {
         icon = databaseIcons()->icon(group->iconNumber(), size);
-    } else {
-        if (group->database()) {
-            icon = Icons::customIconPixmap(group->database(), group->iconUuid(), size);
-        }
     }
 
     if (group->isExpired()) {
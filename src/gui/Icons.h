@@ -47,9 +47,13 @@ public:
 private:
     Icons();
 
+    static QPixmap customIconPixmap(const Database* db, const QUuid& uuid, IconSize size, int badge);
+
     static Icons* m_instance;
 
     QHash<QString, QIcon> m_iconCache;
+    // Decoded and scaled custom icons per database, keyed by icon UUID and size/badge combination
+    QHash<const Metadata*, QHash<QPair<QUuid, int>, QPixmap>> m_customIconCache;
 
     Q_DISABLE_COPY(Icons)
 };
@@ -19,6 +19,7 @@
 #include "CsvImportWidget.h"
 #include "ui_CsvImportWidget.h"
 
+#include <QBuffer>
 #include <QStringListModel>
 
 #include "core/Clock.h"
@@ -188,73 +189,46 @@ QString CsvImportWidget::formatStatusText() const
 
 void CsvImportWidget::writeDatabase()
 {
-    setRootGroup();
-    for (int r = 0; r < m_parserModel->rowCount(); ++r) {
-        // use validity of second column as a GO/NOGO for all others fields
-        if (not m_parserModel->data(m_parserModel->index(r, 1)).isValid()) {
-            continue;
-        }
-        auto entry = new Entry();
-        entry->setUuid(QUuid::createUuid());
-        entry->setGroup(splitGroups(m_parserModel->data(m_parserModel->index(r, 0)).toString()));
-        entry->setTitle(m_parserModel->data(m_parserModel->index(r, 1)).toString());
-        entry->setUsername(m_parserModel->data(m_parserModel->index(r, 2)).toString());
-        entry->setPassword(m_parserModel->data(m_parserModel->index(r, 3)).toString());
-        entry->setUrl(m_parserModel->data(m_parserModel->index(r, 4)).toString());
-        entry->setNotes(m_parserModel->data(m_parserModel->index(r, 5)).toString());
-
-        auto otpString = m_parserModel->data(m_parserModel->index(r, 6));
-        if (otpString.isValid() && !otpString.toString().isEmpty()) {
-            auto totp = Totp::parseSettings(otpString.toString());
-            if (!totp || totp->key.isEmpty()) {
-                // Bare secret, use default TOTP settings
-                totp = Totp::parseSettings({}, otpString.toString());
-            }
-            entry->setTotp(totp);
+    // Entries are placed into their groups once all group labels are known
+    QStringList groupLabels;
+    QHash<QString, QList<Entry*>> entriesByLabel;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    bool good = m_parserModel->parseMapped([&](const CsvRow& fields) {
+        const QString& label = fields.at(0);
+        auto it = entriesByLabel.find(label);
+        if (it == entriesByLabel.end()) {
+            groupLabels.append(label);
+            it = entriesByLabel.insert(label, {});
         }
+        it.value().append(createEntry(fields));
+    });
 
-        bool ok;
-        int icon = m_parserModel->data(m_parserModel->index(r, 7)).toInt(&ok);
-        if (ok) {
-            entry->setIcon(icon);
+    if (!good) {
+        for (const auto& entries : asConst(entriesByLabel)) {
+            qDeleteAll(entries);
         }
+        QApplication::restoreOverrideCursor();
+        MessageBox::warning(this,
+                            tr("Error"),
+                            tr("CSV import: the file could not be read:\n%1").arg(formatStatusText()),
+                            MessageBox::Ok,
+                            MessageBox::Ok);
+        // Importing cleared the preview, show the file as it is now
+        parse();
+        return;
+    }
 
-        TimeInfo timeInfo;
-        if (m_parserModel->data(m_parserModel->index(r, 8)).isValid()) {
-            auto datetime = m_parserModel->data(m_parserModel->index(r, 8)).toString();
-            if (datetime.contains(QRegularExpression("^\\d+$"))) {
-                auto t = datetime.toLongLong();
-                if (t <= INT32_MAX) {
-                    t *= 1000;
-                }
-                auto lastModified = Clock::datetimeUtc(t);
-                timeInfo.setLastModificationTime(lastModified);
-                timeInfo.setLastAccessTime(lastModified);
-            } else {
-                auto lastModified = QDateTime::fromString(datetime, Qt::ISODate);
-                if (lastModified.isValid()) {
-                    timeInfo.setLastModificationTime(lastModified);
-                    timeInfo.setLastAccessTime(lastModified);
-                }
-            }
+    setRootGroup(groupLabels);
+    m_groups.clear();
+    for (const QString& label : asConst(groupLabels)) {
+        Group* group = splitGroups(label);
+        for (Entry* entry : asConst(entriesByLabel[label])) {
+            entry->setGroup(group);
         }
-        if (m_parserModel->data(m_parserModel->index(r, 9)).isValid()) {
-            auto datetime = m_parserModel->data(m_parserModel->index(r, 9)).toString();
-            if (datetime.contains(QRegularExpression("^\\d+$"))) {
-                auto t = datetime.toLongLong();
-                if (t <= INT32_MAX) {
-                    t *= 1000;
-                }
-                timeInfo.setCreationTime(Clock::datetimeUtc(t));
-            } else {
-                auto created = QDateTime::fromString(datetime, Qt::ISODate);
-                if (created.isValid()) {
-                    timeInfo.setCreationTime(created);
-                }
-            }
-        }
-        entry->setTimeInfo(timeInfo);
     }
+    m_groups.clear();
+    QApplication::restoreOverrideCursor();
+
     QBuffer buffer;
     buffer.open(QBuffer::ReadWrite);
 
@@ -270,20 +244,75 @@ void CsvImportWidget::writeDatabase()
     emit editFinished(true);
 }
 
-void CsvImportWidget::setRootGroup()
+Entry* CsvImportWidget::createEntry(const CsvRow& fields)
+{
+    auto entry = new Entry();
+    entry->setUuid(QUuid::createUuid());
+    entry->setTitle(fields.at(1));
+    entry->setUsername(fields.at(2));
+    entry->setPassword(fields.at(3));
+    entry->setUrl(fields.at(4));
+    entry->setNotes(fields.at(5));
+
+    const auto& otpString = fields.at(6);
+    if (!otpString.isEmpty()) {
+        auto totp = Totp::parseSettings(otpString);
+        if (!totp || totp->key.isEmpty()) {
+            // Bare secret, use default TOTP settings
+            totp = Totp::parseSettings({}, otpString);
+        }
+        entry->setTotp(totp);
+    }
+
+    bool ok;
+    int icon = fields.at(7).toInt(&ok);
+    if (ok) {
+        entry->setIcon(icon);
+    }
+
+    static const QRegularExpression timestampRegex("^\\d+$");
+    TimeInfo timeInfo;
+    const auto& lastModifiedString = fields.at(8);
+    if (lastModifiedString.contains(timestampRegex)) {
+        auto t = lastModifiedString.toLongLong();
+        if (t <= INT32_MAX) {
+            t *= 1000;
+        }
+        auto lastModified = Clock::datetimeUtc(t);
+        timeInfo.setLastModificationTime(lastModified);
+        timeInfo.setLastAccessTime(lastModified);
+    } else {
+        auto lastModified = QDateTime::fromString(lastModifiedString, Qt::ISODate);
+        if (lastModified.isValid()) {
+            timeInfo.setLastModificationTime(lastModified);
+            timeInfo.setLastAccessTime(lastModified);
+        }
+    }
+    const auto& createdString = fields.at(9);
+    if (createdString.contains(timestampRegex)) {
+        auto t = createdString.toLongLong();
+        if (t <= INT32_MAX) {
+            t *= 1000;
+        }
+        timeInfo.setCreationTime(Clock::datetimeUtc(t));
+    } else {
+        auto created = QDateTime::fromString(createdString, Qt::ISODate);
+        if (created.isValid()) {
+            timeInfo.setCreationTime(created);
+        }
+    }
+    entry->setTimeInfo(timeInfo);
+    return entry;
+}
+
+void CsvImportWidget::setRootGroup(const QStringList& groupLabels)
 {
-    QString groupLabel;
     QStringList groupList;
     bool is_root = false;
     bool is_empty = false;
     bool is_label = false;
 
-    for (int r = 0; r < m_parserModel->rowCount(); ++r) {
-        // use validity of second column as a GO/NOGO for all others fields
-        if (not m_parserModel->data(m_parserModel->index(r, 1)).isValid()) {
-            continue;
-        }
-        groupLabel = m_parserModel->data(m_parserModel->index(r, 0)).toString();
+    for (const QString& groupLabel : groupLabels) {
         // check if group name is either "root", "" (empty) or some other label
         groupList = groupLabel.split("/", QString::SkipEmptyParts);
         if (groupList.isEmpty()) {
@@ -316,37 +345,26 @@ Group* CsvImportWidget::splitGroups(const QString& label)
 
     QStringList groupList = label.split("/", QString::SkipEmptyParts);
     // avoid the creation of a subgroup with the same name as Root
-    if (m_db->rootGroup()->name() == "Root" && groupList.first() == "Root") {
+    if (m_db->rootGroup()->name() == "Root" && !groupList.isEmpty() && groupList.first() == "Root") {
         groupList.removeFirst();
     }
 
+    QString path;
     for (const QString& groupName : groupList) {
-        Group* children = hasChildren(current, groupName);
-        if (children == nullptr) {
-            auto brandNew = new Group();
-            brandNew->setParent(current);
-            brandNew->setName(groupName);
-            brandNew->setUuid(QUuid::createUuid());
-            current = brandNew;
-        } else {
-            Q_ASSERT(children != nullptr);
-            current = children;
+        path.append("/").append(groupName);
+        Group* group = m_groups.value(path);
+        if (!group) {
+            group = new Group();
+            group->setParent(current);
+            group->setName(groupName);
+            group->setUuid(QUuid::createUuid());
+            m_groups.insert(path, group);
         }
+        current = group;
     }
     return current;
 }
 
-Group* CsvImportWidget::hasChildren(Group* current, const QString& groupName)
-{
-    // returns the group whose name is "groupName" and is child of "current" group
-    for (Group* group : current->children()) {
-        if (group->name() == groupName) {
-            return group;
-        }
-    }
-    return nullptr;
-}
-
 void CsvImportWidget::reject()
 {
     emit editFinished(false);
@@ -49,7 +49,6 @@ private slots:
     void skippedChanged(int rows);
     void writeDatabase();
     void updatePreview();
-    void setRootGroup();
     void reject();
 
 private:
@@ -59,13 +58,16 @@ private:
     QStringListModel* const m_comboModel;
     QList<QComboBox*> m_combos;
     Database* m_db;
+    // groups created by the import, by their path below the root group
+    QHash<QString, Group*> m_groups;
 
     const QStringList m_columnHeader;
     QStringList m_fieldSeparatorList;
     void configParser();
     void updateTableview();
+    Entry* createEntry(const CsvRow& fields);
+    void setRootGroup(const QStringList& groupLabels);
     Group* splitGroups(const QString& label);
-    Group* hasChildren(Group* current, const QString& groupName);
     QString formatStatusText() const;
 };
 
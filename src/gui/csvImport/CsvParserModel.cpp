@@ -20,10 +20,17 @@
 
 #include <QFile>
 
+namespace
+{
+    // Only the start of the file is shown, the import reads the whole file again
+    const int PreviewRows = 1000;
+} // namespace
+
 CsvParserModel::CsvParserModel(QObject* parent)
     : QAbstractTableModel(parent)
     , m_skipped(0)
 {
+    setRowLimit(PreviewRows);
 }
 
 CsvParserModel::~CsvParserModel() = default;
@@ -37,7 +44,7 @@ QString CsvParserModel::getFileInfo()
 {
     QString a(tr("%1, %2, %3", "file info: bytes, rows, columns")
                   .arg(tr("%n byte(s)", nullptr, getFileSize()),
-                       tr("%n row(s)", nullptr, getCsvRows()),
+                       tr("%n row(s)", nullptr, getTotalRows()),
                        tr("%n column(s)", nullptr, qMax(0, getCsvCols() - 1))));
     return a;
 }
@@ -61,6 +68,36 @@ bool CsvParserModel::parse()
     return r;
 }
 
+/**
+ * Parse the whole file without keeping it in memory and pass every row that is not skipped
+ * to the handler, the fields of the row are in the order of the header labels.
+ * The preview is cleared.
+ *
+ * @return false if the file could not be read completely, errors in its content that the
+ *         preview already showed are not reported again
+ */
+bool CsvParserModel::parseMapped(const std::function<void(const CsvRow&)>& rowHandler)
+{
+    beginResetModel();
+    int row = 0;
+    QFile csv(m_filename);
+    CsvParser::parse(&csv, [&](const CsvRow& csvRow) {
+        if (row++ < m_skipped) {
+            return;
+        }
+        CsvRow fields;
+        fields.reserve(m_columnHeader.size());
+        for (int i = 0; i < m_columnHeader.size(); ++i) {
+            // column 0 of the model is the empty column that is not present in the file
+            int column = m_columnMap.value(i);
+            fields.append(column > 0 ? csvRow.value(column - 1) : QString(""));
+        }
+        rowHandler(fields);
+    });
+    endResetModel();
+    return isFileLoaded();
+}
+
 void CsvParserModel::addEmptyColumn()
 {
     for (int i = 0; i < m_table.size(); ++i) {
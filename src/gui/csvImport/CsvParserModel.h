@@ -34,6 +34,7 @@ public:
     void setFilename(const QString& filename);
     QString getFileInfo();
     bool parse();
+    bool parseMapped(const std::function<void(const CsvRow&)>& rowHandler);
 
     void setHeaderLabels(const QStringList& labels);
     void mapColumns(int csvColumn, int dbColumn);
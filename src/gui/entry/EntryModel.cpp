@@ -616,6 +616,32 @@ void EntryModel::makeConnections(const Group* group)
     connect(group, SIGNAL(entryMovedDown()), SLOT(entryMovedDown()));
     connect(group, SIGNAL(entryDataChanged(Entry*)), SLOT(entryDataChanged(Entry*)));
 }
+
+/**
+ * Append entries to the list set with setEntries(), used to stream in search results.
+ */
+void EntryModel::appendEntries(const QList<Entry*>& entries)
+{
+    Q_ASSERT(!m_group);
+    if (entries.isEmpty()) {
+        return;
+    }
+
+    beginInsertRows(QModelIndex(), m_entries.size(), m_entries.size() + entries.size() - 1);
+
+    m_entries.append(entries);
+    m_orgEntries.append(entries);
+
+    for (const auto entry : entries) {
+        if (entry->group() && !m_allGroups.contains(entry->group())) {
+            m_allGroups.insert(entry->group());
+            makeConnections(entry->group());
+        }
+    }
+
+    endInsertRows();
+}
+
 void EntryModel::setBackgroundColorVisible(bool visible)
 {
     m_backgroundColorVisible = visible;
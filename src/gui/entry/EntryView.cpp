@@ -228,6 +228,17 @@ void EntryView::displaySearch(const QList<Entry*>& entries)
     m_inSearchMode = true;
 }
 
+void EntryView::appendSearchResults(const QList<Entry*>& entries)
+{
+    Q_ASSERT(m_inSearchMode);
+
+    bool wasEmpty = m_model->rowCount() == 0;
+    m_model->appendEntries(entries);
+    if (wasEmpty) {
+        setFirstEntryActive();
+    }
+}
+
 void EntryView::setFirstEntryActive()
 {
     if (m_model->rowCount() > 0) {
@@ -51,6 +51,7 @@ public:
 
     void displayGroup(Group* group);
     void displaySearch(const QList<Entry*>& entries);
+    void appendSearchResults(const QList<Entry*>& entries);
 
 signals:
     void entryActivated(Entry* entry, EntryModel::ModelColumn column);
@@ -0,0 +1,330 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PipelineStream.h"
+
+#include <QThread>
+
+#include <functional>
+
+namespace
+{
+    class PipelineStreamWorker : public QThread
+    {
+    public:
+        explicit PipelineStreamWorker(std::function<void()> task)
+            : m_task(std::move(task))
+        {
+        }
+
+    protected:
+        void run() override
+        {
+            m_task();
+        }
+
+    private:
+        const std::function<void()> m_task;
+    };
+} // namespace
+
+PipelineStream::PipelineStream(QIODevice* baseDevice)
+    : PipelineStream(baseDevice, 1024 * 1024, 4)
+{
+}
+
+PipelineStream::PipelineStream(QIODevice* baseDevice, qint32 chunkSize, int queueDepth)
+    : LayeredStream(baseDevice)
+    , m_chunkSize(chunkSize)
+    , m_queueDepth(queueDepth)
+    , m_eof(false)
+    , m_error(false)
+    , m_stop(false)
+    , m_writing(false)
+    , m_chunkPos(0)
+{
+    Q_ASSERT(chunkSize > 0);
+    Q_ASSERT(queueDepth > 0);
+}
+
+PipelineStream::~PipelineStream()
+{
+    close();
+}
+
+bool PipelineStream::open(QIODevice::OpenMode mode)
+{
+    if (!LayeredStream::open(mode)) {
+        return false;
+    }
+
+    m_queue.clear();
+    m_workerError.clear();
+    m_eof = false;
+    m_error = false;
+    m_stop = false;
+    m_writing = false;
+    m_chunk.clear();
+    m_chunkPos = 0;
+
+    if (isWritable()) {
+        m_chunk.reserve(m_chunkSize);
+        m_worker.reset(new PipelineStreamWorker([this] { runWriter(); }));
+    } else {
+        m_worker.reset(new PipelineStreamWorker([this] { runReader(); }));
+    }
+    m_worker->start();
+
+    return true;
+}
+
+/**
+ * In write mode, block until all data written so far has been written to the base device.
+ *
+ * @return false if the worker failed to write to the base device
+ */
+bool PipelineStream::reset()
+{
+    if (!isWritable()) {
+        return LayeredStream::reset();
+    }
+
+    if (!m_chunk.isEmpty() && !putChunk()) {
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    while ((!m_queue.isEmpty() || m_writing) && !m_error) {
+        m_spaceAvailable.wait(&m_mutex);
+    }
+
+    if (m_error) {
+        setErrorString(m_workerError);
+        return false;
+    }
+    return true;
+}
+
+void PipelineStream::close()
+{
+    if (isWritable() && m_worker) {
+        reset();
+    }
+    stopWorker();
+    LayeredStream::close();
+}
+
+void PipelineStream::stopWorker()
+{
+    if (!m_worker) {
+        return;
+    }
+
+    m_mutex.lock();
+    m_stop = true;
+    m_spaceAvailable.wakeAll();
+    m_chunkAvailable.wakeAll();
+    m_mutex.unlock();
+
+    m_worker->wait();
+    m_worker.reset();
+}
+
+void PipelineStream::runReader()
+{
+    while (true) {
+        QByteArray chunk(m_chunkSize, Qt::Uninitialized);
+        qint64 readResult = m_baseDevice->read(chunk.data(), chunk.size());
+
+        QMutexLocker locker(&m_mutex);
+        if (readResult < 0) {
+            m_error = true;
+            m_workerError = m_baseDevice->errorString();
+            m_chunkAvailable.wakeAll();
+            return;
+        } else if (readResult == 0) {
+            m_eof = true;
+            m_chunkAvailable.wakeAll();
+            return;
+        }
+
+        while (m_queue.size() >= m_queueDepth && !m_stop) {
+            m_spaceAvailable.wait(&m_mutex);
+        }
+        if (m_stop) {
+            return;
+        }
+
+        chunk.resize(static_cast<int>(readResult));
+        m_queue.enqueue(chunk);
+        m_chunkAvailable.wakeOne();
+    }
+}
+
+void PipelineStream::runWriter()
+{
+    while (true) {
+        QByteArray chunk;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_queue.isEmpty() && !m_stop) {
+                m_chunkAvailable.wait(&m_mutex);
+            }
+            if (m_stop) {
+                return;
+            }
+
+            chunk = m_queue.dequeue();
+            m_writing = true;
+        }
+
+        qint64 writeResult = m_baseDevice->write(chunk);
+
+        QMutexLocker locker(&m_mutex);
+        m_writing = false;
+        if (writeResult != chunk.size()) {
+            m_error = true;
+            m_workerError = m_baseDevice->errorString();
+            m_spaceAvailable.wakeAll();
+            return;
+        }
+        m_spaceAvailable.wakeAll();
+    }
+}
+
+bool PipelineStream::putChunk()
+{
+    QMutexLocker locker(&m_mutex);
+    while (m_queue.size() >= m_queueDepth && !m_error) {
+        m_spaceAvailable.wait(&m_mutex);
+    }
+
+    if (m_error) {
+        setErrorString(m_workerError);
+        return false;
+    }
+
+    m_queue.enqueue(m_chunk);
+    m_chunk = QByteArray();
+    m_chunk.reserve(m_chunkSize);
+    m_chunkAvailable.wakeOne();
+    return true;
+}
+
+bool PipelineStream::takeChunk()
+{
+    QMutexLocker locker(&m_mutex);
+    while (m_queue.isEmpty() && !m_eof && !m_error) {
+        m_chunkAvailable.wait(&m_mutex);
+    }
+
+    if (m_error) {
+        setErrorString(m_workerError);
+        return false;
+    } else if (m_queue.isEmpty()) {
+        return false;
+    }
+
+    m_chunk = m_queue.dequeue();
+    m_chunkPos = 0;
+    m_spaceAvailable.wakeOne();
+    return true;
+}
+
+qint64 PipelineStream::readData(char* data, qint64 maxSize)
+{
+    Q_ASSERT(maxSize >= 0);
+
+    qint64 bytesRemaining = maxSize;
+    qint64 offset = 0;
+
+    while (bytesRemaining > 0) {
+        if (m_chunkPos == m_chunk.size()) {
+            if (!takeChunk()) {
+                QMutexLocker locker(&m_mutex);
+                if (m_error) {
+                    return -1;
+                }
+                return maxSize - bytesRemaining;
+            }
+        }
+
+        qint64 bytesToCopy = qMin(bytesRemaining, static_cast<qint64>(m_chunk.size() - m_chunkPos));
+
+        memcpy(data + offset, m_chunk.constData() + m_chunkPos, static_cast<size_t>(bytesToCopy));
+
+        offset += bytesToCopy;
+        m_chunkPos += static_cast<int>(bytesToCopy);
+        bytesRemaining -= bytesToCopy;
+    }
+
+    return maxSize;
+}
+
+qint64 PipelineStream::writeData(const char* data, qint64 maxSize)
+{
+    Q_ASSERT(maxSize >= 0);
+
+    qint64 bytesRemaining = maxSize;
+    qint64 offset = 0;
+
+    while (bytesRemaining > 0) {
+        qint64 bytesToCopy = qMin(bytesRemaining, static_cast<qint64>(m_chunkSize - m_chunk.size()));
+
+        m_chunk.append(data + offset, static_cast<int>(bytesToCopy));
+
+        offset += bytesToCopy;
+        bytesRemaining -= bytesToCopy;
+
+        if (m_chunk.size() == m_chunkSize && !putChunk()) {
+            return -1;
+        }
+    }
+
+    return maxSize;
+}
+
+/**
+ * Blocks until the worker either queued more data or reached the end of the base device.
+ */
+bool PipelineStream::atEnd() const
+{
+    if (!isOpen() || !m_worker) {
+        return true;
+    }
+    if (m_chunkPos < m_chunk.size()) {
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    while (m_queue.isEmpty() && !m_eof && !m_error) {
+        m_chunkAvailable.wait(&m_mutex);
+    }
+    return m_queue.isEmpty();
+}
+
+qint64 PipelineStream::bytesAvailable() const
+{
+    qint64 available = m_chunk.size() - m_chunkPos;
+
+    QMutexLocker locker(&m_mutex);
+    for (const auto& chunk : m_queue) {
+        available += chunk.size();
+    }
+
+    return available + LayeredStream::bytesAvailable();
+}
@@ -0,0 +1,87 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_PIPELINESTREAM_H
+#define KEEPASSX_PIPELINESTREAM_H
+
+#include <QMutex>
+#include <QQueue>
+#include <QScopedPointer>
+#include <QWaitCondition>
+
+#include "streams/LayeredStream.h"
+
+class QThread;
+
+/**
+ * Layered stream that decouples its base device onto a dedicated worker thread.
+ *
+ * In read mode the worker pulls fixed-size chunks from the base device into a
+ * bounded queue which readData() drains. In write mode writeData() collects the
+ * data into fixed-size chunks which the worker pushes to the base device, use
+ * reset() to wait until everything has been written. Stacking several pipeline
+ * streams between the layers of an encoding or decoding chain lets every layer
+ * run concurrently.
+ *
+ * The base device must not be accessed by anyone else while the stream is open.
+ */
+class PipelineStream : public LayeredStream
+{
+    Q_OBJECT
+
+public:
+    explicit PipelineStream(QIODevice* baseDevice);
+    PipelineStream(QIODevice* baseDevice, qint32 chunkSize, int queueDepth);
+    ~PipelineStream() override;
+
+    bool open(QIODevice::OpenMode mode) override;
+    bool reset() override;
+    void close() override;
+
+    bool atEnd() const override;
+    qint64 bytesAvailable() const override;
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override;
+    qint64 writeData(const char* data, qint64 maxSize) override;
+
+private:
+    void runReader();
+    void runWriter();
+    bool takeChunk();
+    bool putChunk();
+    void stopWorker();
+
+    const qint32 m_chunkSize;
+    const int m_queueDepth;
+    QScopedPointer<QThread> m_worker;
+
+    mutable QMutex m_mutex;
+    mutable QWaitCondition m_chunkAvailable;
+    QWaitCondition m_spaceAvailable;
+    QQueue<QByteArray> m_queue;
+    QString m_workerError;
+    bool m_eof;
+    bool m_error;
+    bool m_stop;
+    bool m_writing;
+
+    QByteArray m_chunk;
+    int m_chunkPos;
+};
+
+#endif // KEEPASSX_PIPELINESTREAM_H
@@ -21,7 +21,6 @@ SymmetricCipherStream::SymmetricCipherStream(QIODevice* baseDevice)
     : LayeredStream(baseDevice)
     , m_cipher(new SymmetricCipher())
     , m_bufferPos(0)
-    , m_bufferFilling(false)
     , m_error(false)
     , m_isInitialized(false)
     , m_dataWritten(false)
@@ -45,14 +44,15 @@ bool SymmetricCipherStream::init(SymmetricCipher::Mode mode,
         return false;
     }
     m_streamCipher = m_cipher->blockSize(m_cipher->mode()) == 1;
+    Q_ASSERT(m_streamCipher || BufferSize % m_cipher->blockSize(m_cipher->mode()) == 0);
     return true;
 }
 
 void SymmetricCipherStream::resetInternalState()
 {
     m_buffer.clear();
+    m_heldBack.clear();
     m_bufferPos = 0;
-    m_bufferFilling = false;
     m_error = false;
     m_dataWritten = false;
     m_cipher->reset();
@@ -99,7 +99,7 @@ qint64 SymmetricCipherStream::readData(char* data, qint64 maxSize)
     qint64 offset = 0;
 
     while (bytesRemaining > 0) {
-        if ((m_bufferPos == m_buffer.size()) || m_bufferFilling) {
+        if (m_bufferPos == m_buffer.size()) {
             if (!readBlock()) {
                 if (m_error) {
                     return -1;
@@ -121,49 +121,67 @@ qint64 SymmetricCipherStream::readData(char* data, qint64 maxSize)
     return maxSize;
 }
 
+/**
+ * Read and decrypt the next chunk of up to BufferSize bytes from the base device.
+ *
+ * Block ciphers always hold back the last (possibly partial) block of every chunk
+ * since it may carry the padding. It is finished once the base device is exhausted.
+ *
+ * @return true if decrypted data is available in the buffer
+ */
 bool SymmetricCipherStream::readBlock()
 {
-    QByteArray newData;
-
-    if (m_bufferFilling) {
-        newData.resize(blockSize() - m_buffer.size());
-    } else {
-        m_buffer.clear();
-        newData.resize(blockSize());
-    }
-
-    int readResult = m_baseDevice->read(newData.data(), newData.size());
+    m_buffer.clear();
+    m_bufferPos = 0;
 
-    if (readResult == -1) {
-        m_error = true;
-        setErrorString(m_baseDevice->errorString());
-        return false;
-    } else {
-        m_buffer.append(newData.left(readResult));
-    }
+    while (m_buffer.isEmpty()) {
+        QByteArray chunk = m_heldBack;
+        const int heldBackSize = chunk.size();
+        chunk.resize(heldBackSize + BufferSize);
 
-    if (!m_streamCipher && m_buffer.size() != blockSize()) {
-        m_bufferFilling = true;
-        return false;
-    } else {
-        m_bufferPos = 0;
-        m_bufferFilling = false;
+        qint64 readResult = m_baseDevice->read(chunk.data() + heldBackSize, BufferSize);
+        if (readResult == -1) {
+            m_error = true;
+            setErrorString(m_baseDevice->errorString());
+            return false;
+        }
+        chunk.resize(heldBackSize + static_cast<int>(readResult));
 
-        if (!m_streamCipher && m_baseDevice->atEnd()) {
-            if (!m_cipher->finish(m_buffer)) {
+        if (readResult == 0) {
+            m_heldBack.clear();
+            if (chunk.isEmpty()) {
+                return false;
+            }
+            if (!m_cipher->finish(chunk)) {
                 m_error = true;
                 setErrorString(m_cipher->errorString());
                 return false;
             }
-        } else if (m_buffer.size() > 0) {
-            if (!m_cipher->process(m_buffer)) {
+            m_buffer = chunk;
+            return !m_buffer.isEmpty();
+        }
+
+        if (!m_streamCipher) {
+            const int cipherBlockSize = m_cipher->blockSize(m_cipher->mode());
+            int heldBack = chunk.size() % cipherBlockSize;
+            if (heldBack == 0) {
+                heldBack = cipherBlockSize;
+            }
+            m_heldBack = chunk.right(heldBack);
+            chunk.chop(heldBack);
+        }
+
+        if (!chunk.isEmpty()) {
+            if (!m_cipher->process(chunk)) {
                 m_error = true;
                 setErrorString(m_cipher->errorString());
                 return false;
             }
+            m_buffer = chunk;
         }
-        return m_buffer.size() > 0;
     }
+
+    return true;
 }
 
 qint64 SymmetricCipherStream::writeData(const char* data, qint64 maxSize)
@@ -179,14 +197,14 @@ qint64 SymmetricCipherStream::writeData(const char* data, qint64 maxSize)
     qint64 offset = 0;
 
     while (bytesRemaining > 0) {
-        int bytesToCopy = qMin(bytesRemaining, static_cast<qint64>(blockSize() - m_buffer.size()));
+        int bytesToCopy = qMin(bytesRemaining, static_cast<qint64>(BufferSize - m_buffer.size()));
 
         m_buffer.append(data + offset, bytesToCopy);
 
         offset += bytesToCopy;
         bytesRemaining -= bytesToCopy;
 
-        if (m_buffer.size() == blockSize()) {
+        if (m_buffer.size() == BufferSize) {
             if (!writeBlock(false)) {
                 if (m_error) {
                     return -1;
@@ -202,15 +220,17 @@ qint64 SymmetricCipherStream::writeData(const char* data, qint64 maxSize)
 
 bool SymmetricCipherStream::writeBlock(bool lastBlock)
 {
-    Q_ASSERT(m_streamCipher || lastBlock || (m_buffer.size() == blockSize()));
+    Q_ASSERT(lastBlock || (m_buffer.size() == BufferSize));
 
     if (lastBlock && !m_streamCipher) {
-        QByteArray end;
         if (!m_cipher->finish(m_buffer)) {
             m_error = true;
             setErrorString(m_cipher->errorString());
             return false;
         }
+    } else if (m_buffer.isEmpty()) {
+        // nothing left to flush for stream ciphers
+        return true;
     } else if (!m_cipher->process(m_buffer)) {
         m_error = true;
         setErrorString(m_cipher->errorString());
@@ -226,11 +246,3 @@ bool SymmetricCipherStream::writeBlock(bool lastBlock)
         return true;
     }
 }
-
-int SymmetricCipherStream::blockSize() const
-{
-    if (m_streamCipher) {
-        return 1024;
-    }
-    return m_cipher->blockSize(m_cipher->mode());
-}
@@ -45,12 +45,14 @@ private:
     void resetInternalState();
     bool readBlock();
     bool writeBlock(bool lastBlock);
-    int blockSize() const;
+
+    // Process data in large chunks so Botan can use its multi-block (e.g. AES-NI) code paths
+    static const int BufferSize = 64 * 1024;
 
     const QScopedPointer<SymmetricCipher> m_cipher;
     QByteArray m_buffer;
+    QByteArray m_heldBack;
     int m_bufferPos;
-    bool m_bufferFilling;
     bool m_error;
     bool m_isInitialized;
     bool m_dataWritten;
@@ -400,6 +400,59 @@ void TestBrowser::testSearchEntriesWithAdditionalURLs()
     QCOMPARE(additionalResult[0]->url(), QString("https://github.com/"));
 }
 
+void TestBrowser::testSearchEntriesIndex()
+{
+    auto db = QSharedPointer<Database>::create();
+    auto* root = db->rootGroup();
+    auto* group = new Group();
+    group->setParent(root);
+
+    QStringList urls = {"https://github.com/login", "https://keepassxc.org"};
+    auto entries = createEntries(urls, group);
+
+    auto result = m_browserService->searchEntries(db, "https://github.com", "https://github.com/session");
+    QCOMPARE(result.length(), 1);
+    QCOMPARE(result[0], entries[0]);
+
+    // Entries added, modified and removed after the first lookup are picked up
+    QStringList moreUrls = {"https://gist.github.com"};
+    auto moreEntries = createEntries(moreUrls, root);
+    entries[1]->setUrl("github.com");
+    entries[0]->attributes()->set(EntryAttributes::AdditionalUrlAttribute, "https://keepassxc.org");
+
+    // Results stay in tree order, entries of a group before those of its subgroups
+    result = m_browserService->searchEntries(db, "https://github.com", "https://github.com/session");
+    QCOMPARE(result.length(), 3);
+    QCOMPARE(result[0], moreEntries[0]);
+    QCOMPARE(result[1], entries[0]);
+    QCOMPARE(result[2], entries[1]);
+
+    result = m_browserService->searchEntries(db, "https://keepassxc.org", "https://keepassxc.org");
+    QCOMPARE(result.length(), 1);
+    QCOMPARE(result[0], entries[0]);
+
+    delete moreEntries[0];
+    entries[1]->setGroup(root);
+    group->setCustomDataTriState(BrowserService::OPTION_HIDE_ENTRY, Group::Enable);
+    result = m_browserService->searchEntries(db, "https://github.com", "https://github.com/session");
+    QCOMPARE(result.length(), 1);
+    QCOMPARE(result[0], entries[1]);
+
+    // Entries referencing other entries' URLs are always considered
+    auto* referencing = new Entry();
+    referencing->setGroup(root);
+    referencing->setUrl(QString("{REF:A@I:%1}").arg(entries[1]->uuidToHex()));
+    result = m_browserService->searchEntries(db, "https://github.com", "https://github.com/session");
+    QCOMPARE(result.length(), 2);
+    QCOMPARE(result[1], referencing);
+
+    entries[1]->setUrl("https://keepassxc.org");
+    result = m_browserService->searchEntries(db, "https://github.com", "https://github.com/session");
+    QCOMPARE(result.length(), 0);
+    result = m_browserService->searchEntries(db, "https://keepassxc.org", "https://keepassxc.org");
+    QCOMPARE(result.length(), 2);
+}
+
 void TestBrowser::testInvalidEntries()
 {
     auto db = QSharedPointer<Database>::create();
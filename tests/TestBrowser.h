@@ -45,6 +45,7 @@ private slots:
     void testSearchEntriesByReference();
     void testSearchEntriesWithPort();
     void testSearchEntriesWithAdditionalURLs();
+    void testSearchEntriesIndex();
     void testInvalidEntries();
     void testSubdomainsAndPaths();
     void testBestMatchingCredentials();
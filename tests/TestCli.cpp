@@ -29,6 +29,7 @@
 
 #include "cli/Add.h"
 #include "cli/AddGroup.h"
+#include "cli/Agent.h"
 #include "cli/Analyze.h"
 #include "cli/AttachmentExport.h"
 #include "cli/AttachmentImport.h"
@@ -221,6 +222,7 @@ void TestCli::testBatchCommands()
 {
     Commands::setupCommands(false);
     QVERIFY(Commands::getCommand("add"));
+    QVERIFY(Commands::getCommand("agent"));
     QVERIFY(Commands::getCommand("analyze"));
     QVERIFY(Commands::getCommand("attachment-export"));
     QVERIFY(Commands::getCommand("attachment-import"));
@@ -246,7 +248,7 @@ void TestCli::testBatchCommands()
     QVERIFY(Commands::getCommand("show"));
     QVERIFY(Commands::getCommand("search"));
     QVERIFY(!Commands::getCommand("doesnotexist"));
-    QCOMPARE(Commands::getCommands().size(), 26);
+    QCOMPARE(Commands::getCommands().size(), 27);
 }
 
 void TestCli::testInteractiveCommands()
@@ -265,6 +267,7 @@ void TestCli::testInteractiveCommands()
     QVERIFY(Commands::getCommand("edit"));
     QVERIFY(Commands::getCommand("estimate"));
     QVERIFY(Commands::getCommand("exit"));
+    QVERIFY(!Commands::getCommand("agent"));
     QVERIFY(Commands::getCommand("generate"));
     QVERIFY(Commands::getCommand("help"));
     QVERIFY(Commands::getCommand("ls"));
@@ -431,6 +434,88 @@ void TestCli::testAddGroup()
     QCOMPARE(m_stdout->readAll(), QByteArray());
 }
 
+void TestCli::testAgent()
+{
+    Agent agentCmd;
+    QVERIFY(!agentCmd.name.isEmpty());
+    QVERIFY(agentCmd.getDescriptionLine().contains(agentCmd.name));
+
+    // Stopping requires a running agent
+    QCOMPARE(execCmd(agentCmd, {"agent", "stop", m_dbFile->fileName()}), EXIT_FAILURE);
+    QVERIFY(m_stderr->readAll().contains("No agent is running"));
+
+    QProcess agent;
+    agent.start(KEEPASSX_CLI_PATH, {"agent", "start", "-t", "60", m_dbFile->fileName()});
+    QVERIFY(agent.waitForStarted());
+    agent.write("a\n");
+    agent.closeWriteChannel();
+    QByteArray agentOutput;
+    QTRY_VERIFY_WITH_TIMEOUT((agentOutput += agent.readAllStandardOutput()).contains("Agent started"), 10000);
+
+    // Commands are run by the agent without unlocking the database
+    Show showCmd;
+    QCOMPARE(execCmd(showCmd, {"show", m_dbFile->fileName(), "/Sample Entry"}), EXIT_SUCCESS);
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+    QCOMPARE(m_stdout->readAll(),
+             QByteArray("Title: Sample Entry\n"
+                        "UserName: User Name\n"
+                        "Password: PROTECTED\n"
+                        "URL: http://www.somesite.com/\n"
+                        "Notes: Notes\n"
+                        "Uuid: {9f4544c2-ab00-c74a-8a1a-6eaf26cf57e9}\n"
+                        "Tags: \n"));
+
+    Add addCmd;
+    QCOMPARE(execCmd(addCmd, {"add", "-u", "agentuser", m_dbFile->fileName(), "/agent-entry"}), EXIT_SUCCESS);
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+    QVERIFY(m_stdout->readAll().contains("Successfully added entry agent-entry."));
+    auto db = readDatabase();
+    QVERIFY(db->rootGroup()->findEntryByPath("/agent-entry"));
+
+    // Changes made by others are picked up
+    auto* entry = new Entry();
+    entry->setUuid(QUuid::createUuid());
+    entry->setTitle("external-entry");
+    entry->setGroup(db->rootGroup());
+    QVERIFY(db->save(Database::Atomic));
+    List listCmd;
+    QCOMPARE(execCmd(listCmd, {"ls", m_dbFile->fileName()}), EXIT_SUCCESS);
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+    QVERIFY(m_stdout->readAll().contains("external-entry"));
+
+#if !defined(Q_OS_WIN)
+    // Changes of a command that failed to save are dropped, changing the permissions does not
+    // touch the modification time so the agent has to read the file again on its own
+    QVERIFY(QFile::setPermissions(m_dbFile->fileName(), QFile::ReadOwner));
+    if (!QFileInfo(m_dbFile->fileName()).isWritable()) {
+        QCOMPARE(execCmd(addCmd, {"add", m_dbFile->fileName(), "/unsaved-entry"}), EXIT_FAILURE);
+        QVERIFY(m_stderr->readAll().contains("Writing the database failed"));
+    }
+    QVERIFY(QFile::setPermissions(m_dbFile->fileName(), QFile::ReadOwner | QFile::WriteOwner));
+    QCOMPARE(execCmd(listCmd, {"ls", m_dbFile->fileName()}), EXIT_SUCCESS);
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+    QVERIFY(!m_stdout->readAll().contains("unsaved-entry"));
+#endif
+
+    // Clip waits for the clipboard timeout, it must not keep the agent busy
+    Clip clipCmd;
+    QVERIFY(!clipCmd.canRunInAgent(clipCmd.getCommandLineParser({"clip", m_dbFile->fileName(), "/Sample Entry"})));
+
+    // Commands that prompt for input unlock the database themselves
+    setInput({"a", "newpassword"});
+    QCOMPARE(execCmd(addCmd, {"add", "-p", m_dbFile->fileName(), "/prompted-entry"}), EXIT_SUCCESS);
+    QVERIFY(m_stderr->readAll().contains("Enter password to unlock"));
+
+    QCOMPARE(execCmd(agentCmd, {"agent", "stop", m_dbFile->fileName()}), EXIT_SUCCESS);
+    QVERIFY(agent.waitForFinished());
+    QCOMPARE(agent.exitCode(), EXIT_SUCCESS);
+
+    // Without an agent the database is unlocked again
+    setInput("a");
+    QCOMPARE(execCmd(showCmd, {"show", m_dbFile->fileName(), "/agent-entry"}), EXIT_SUCCESS);
+    QVERIFY(m_stderr->readAll().contains("Enter password to unlock"));
+}
+
 void TestCli::testAnalyze()
 {
     Analyze analyzeCmd;
@@ -46,6 +46,7 @@ private slots:
     void testBatchCommands();
     void testAdd();
     void testAddGroup();
+    void testAgent();
     void testAnalyze();
     void testAttachmentExport();
     void testAttachmentImport();
@@ -26,8 +26,54 @@
 #include "crypto/Crypto.h"
 #include "format/CsvExporter.h"
 
+#ifdef Q_OS_LINUX
+#include <sys/resource.h>
+#endif
+
 QTEST_GUILESS_MAIN(TestCsvExporter)
 
+namespace
+{
+    // Discards everything written to it, only the number of bytes is kept
+    class CountingDevice : public QIODevice
+    {
+    public:
+        qint64 bytesWritten = 0;
+
+    protected:
+        qint64 readData(char*, qint64) override
+        {
+            return -1;
+        }
+
+        qint64 writeData(const char*, qint64 maxSize) override
+        {
+            bytesWritten += maxSize;
+            return maxSize;
+        }
+    };
+
+    void populate(Database* db, int numEntries, int notesSize)
+    {
+        const QString notes(notesSize, QChar('n'));
+        for (int i = 0; i < numEntries; ++i) {
+            auto* entry = new Entry();
+            entry->setGroup(db->rootGroup());
+            entry->setTitle(QString("Entry %1").arg(i));
+            entry->setNotes(notes);
+        }
+    }
+
+#ifdef Q_OS_LINUX
+    qint64 peakMemoryKb()
+    {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+#endif
+} // namespace
+
 const QString TestCsvExporter::ExpectedHeaderLine =
     QString("\"Group\",\"Title\",\"Username\",\"Password\",\"URL\",\"Notes\",\"TOTP\",\"Icon\",\"Last "
             "Modified\",\"Created\"\n");
@@ -110,3 +156,47 @@ void TestCsvExporter::testNestedGroups()
             .append(ExpectedHeaderLine)
             .append("\"Passwords/Test Group Name/Test Sub Group Name\",\"Test Entry Title\",\"\",\"\",\"\",\"\"")));
 }
+
+void TestCsvExporter::testLargeExport()
+{
+    // Spans many flushes of the internal buffer
+    populate(m_db.data(), 1000, 200);
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::ReadWrite));
+    QVERIFY(m_csvExporter->exportDatabase(&buffer, m_db));
+    const auto lines = QString::fromUtf8(buffer.buffer()).split("\n", QString::SkipEmptyParts);
+    QCOMPARE(lines.size(), 1001);
+    QCOMPARE(lines.first() + "\n", ExpectedHeaderLine);
+    QVERIFY(lines.last().startsWith("\"Passwords\",\"Entry 999\""));
+    QCOMPARE(m_csvExporter->exportDatabase(m_db), QString::fromUtf8(buffer.buffer()));
+}
+
+void TestCsvExporter::testPeakMemory()
+{
+#if !defined(Q_OS_LINUX)
+    QSKIP("Peak memory usage is only measured on Linux");
+#elif defined(WITH_ASAN)
+    QSKIP("Peak memory usage is meaningless with the quarantine and shadow memory of the address sanitizer");
+#else
+    populate(m_db.data(), 20000, 1024);
+
+    // The peak only grows if the export allocates more than building the database did
+    const qint64 peakBefore = peakMemoryKb();
+
+    CountingDevice csvDevice;
+    QVERIFY(csvDevice.open(QIODevice::WriteOnly));
+    QVERIFY(m_csvExporter->exportDatabase(&csvDevice, m_db));
+
+    CountingDevice xmlDevice;
+    QVERIFY(xmlDevice.open(QIODevice::WriteOnly));
+    QString error;
+    QVERIFY2(m_db->extract(&xmlDevice, &error), qPrintable(error));
+
+    const qint64 growth = (peakMemoryKb() - peakBefore) * 1024;
+    QVERIFY(csvDevice.bytesWritten > 20000 * 1024);
+    QVERIFY(xmlDevice.bytesWritten > 20000 * 1024);
+    QVERIFY2(growth < csvDevice.bytesWritten / 4,
+             qPrintable(QString("Peak memory grew by %1 bytes during the export").arg(growth)));
+#endif
+}
@@ -39,6 +39,8 @@ private slots:
     void testExport();
     void testEmptyDatabase();
     void testNestedGroups();
+    void testLargeExport();
+    void testPeakMemory();
 
 private:
     QSharedPointer<Database> m_db;
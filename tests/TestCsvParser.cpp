@@ -19,6 +19,7 @@
 #include "TestCsvParser.h"
 
 #include <QTest>
+#include <QTextStream>
 
 QTEST_GUILESS_MAIN(TestCsvParser)
 
@@ -344,3 +345,72 @@ void TestCsvParser::testUnicode()
     QVERIFY(t.at(0).at(2) == "3śAż");
     QVERIFY(t.at(0).at(3) == "żac");
 }
+
+void TestCsvParser::testChunkBoundaries()
+{
+    // The file is decoded in chunks of 64 KiB, put a line break and a multibyte character across the borders
+    const QString first(64 * 1024 - 1, QChar('a'));
+    const QString second(64 * 1024 - 2, QChar('b'));
+    QTextStream out(file.data());
+    out.setCodec("UTF-8");
+    out << first << "\r\n" << second << "\u20AC,\"x\r\ny\"\n3,4";
+    QVERIFY(parser->parse(file.data()));
+    t = parser->getCsvTable();
+    QCOMPARE(t.size(), 3);
+    QCOMPARE(t.at(0).at(0), first);
+    QCOMPARE(t.at(1).at(0), second + QString("\u20AC"));
+    QCOMPARE(t.at(1).at(1), QString("x\ny"));
+    QCOMPARE(t.at(2).at(0), QString("3"));
+    QCOMPARE(t.at(2).at(1), QString("4"));
+}
+
+void TestCsvParser::testRowLimit()
+{
+    QTextStream out(file.data());
+    for (int i = 0; i < 100; ++i) {
+        out << i << "," << (i == 99 ? ",,last" : "x") << "\n";
+    }
+    parser->setRowLimit(10);
+    QVERIFY(parser->parse(file.data()));
+    parser->setRowLimit(0);
+    t = parser->getCsvTable();
+    QCOMPARE(t.size(), 10);
+    QCOMPARE(parser->getCsvRows(), 10);
+    QCOMPARE(parser->getTotalRows(), 100);
+    // columns are counted over the whole file
+    QCOMPARE(parser->getCsvCols(), 4);
+    QCOMPARE(t.at(9).at(0), QString("9"));
+}
+
+void TestCsvParser::testRowHandler()
+{
+    QTextStream out(file.data());
+    out << "1,2\n"
+        << "# comment\n"
+        << "3,\"4\n5\"\n";
+    out.flush();
+
+    CsvTable rows;
+    QVERIFY(parser->parse(file.data(), [&rows](const CsvRow& row) { rows.append(row); }));
+    QVERIFY(parser->getCsvTable().isEmpty());
+    QCOMPARE(parser->getTotalRows(), 2);
+    QCOMPARE(rows.size(), 2);
+    QCOMPARE(rows.at(0), CsvRow({"1", "2"}));
+    QCOMPARE(rows.at(1), CsvRow({"3", "4\n5"}));
+}
+
+void TestCsvParser::testUnreadableFile()
+{
+    QTextStream out(file.data());
+    out << "1,2\n";
+    QVERIFY(parser->parse(file.data()));
+    QVERIFY(parser->isFileLoaded());
+
+    // the file went away after the preview
+    QFile missing(file->fileName() + ".missing");
+    int rows = 0;
+    QVERIFY(!parser->parse(&missing, [&rows](const CsvRow&) { ++rows; }));
+    QVERIFY(!parser->isFileLoaded());
+    QVERIFY(parser->getStatus().contains("error reading from device"));
+    QCOMPARE(rows, 0);
+}
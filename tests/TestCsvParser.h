@@ -57,6 +57,10 @@ private slots:
     void testQuoted();
     void testMultiline();
     void testColumns();
+    void testChunkBoundaries();
+    void testRowLimit();
+    void testRowHandler();
+    void testUnreadableFile();
 
 private:
     QScopedPointer<QTemporaryFile> file;
@@ -23,11 +23,13 @@
 #include <QTest>
 
 #include "config-keepassx-tests.h"
+#include "core/DatabaseDiff.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
 #include "core/Tools.h"
 #include "crypto/Crypto.h"
 #include "format/KeePass2Writer.h"
+#include "mock/MockClock.h"
 #include "util/TemporaryFile.h"
 
 QTEST_GUILESS_MAIN(TestDatabase)
@@ -127,6 +129,200 @@ void TestDatabase::testSaveAs()
     QCOMPARE(error, QString("Could not save, database has not been initialized!"));
 }
 
+void TestDatabase::testKeyPrecomputation()
+{
+    TemporaryFile tempFile;
+    QVERIFY(tempFile.copyFromFile(dbFileName));
+
+    auto db = QSharedPointer<Database>::create();
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create("a"));
+
+    QString error;
+    QVERIFY(db->open(tempFile.fileName(), key, &error));
+    db->setKeyPrecomputationEnabled(true);
+    QVERIFY(db->isKeyPrecomputationEnabled());
+
+    // Consecutive saves must use a fresh seed each time and stay readable
+    auto seed = db->kdf()->seed();
+    db->metadata()->setName("precomputed");
+    QVERIFY2(db->save(Database::Atomic, {}, &error), error.toLatin1());
+    QVERIFY(db->kdf()->seed() != seed);
+    seed = db->kdf()->seed();
+    db->metadata()->setName("precomputed2");
+    QVERIFY2(db->save(Database::Atomic, {}, &error), error.toLatin1());
+    QVERIFY(db->kdf()->seed() != seed);
+
+    auto reopened = QSharedPointer<Database>::create();
+    QVERIFY2(reopened->open(tempFile.fileName(), key, &error), error.toLatin1());
+    QCOMPARE(reopened->metadata()->name(), QString("precomputed2"));
+
+    // A key change must not reuse a key pre-computed for the old key
+    auto newKey = QSharedPointer<CompositeKey>::create();
+    newKey->addKey(QSharedPointer<PasswordKey>::create("b"));
+    QVERIFY(db->setKey(newKey, true, false, false));
+    QVERIFY2(db->save(Database::Atomic, {}, &error), error.toLatin1());
+
+    reopened = QSharedPointer<Database>::create();
+    QVERIFY(!reopened->open(tempFile.fileName(), key, &error));
+    reopened = QSharedPointer<Database>::create();
+    QVERIFY2(reopened->open(tempFile.fileName(), newKey, &error), error.toLatin1());
+
+    // The same applies to KDF parameter changes
+    auto kdf = db->kdf()->clone();
+    kdf->setRounds(kdf->rounds() + 1);
+    QVERIFY(db->changeKdf(kdf));
+    QVERIFY2(db->save(Database::Atomic, {}, &error), error.toLatin1());
+
+    reopened = QSharedPointer<Database>::create();
+    QVERIFY2(reopened->open(tempFile.fileName(), newKey, &error), error.toLatin1());
+    QCOMPARE(reopened->kdf()->rounds(), kdf->rounds());
+
+    // Discarded computations must not keep a replaced key alive, and locking releases the current one
+    QWeakPointer<CompositeKey> oldKey = key;
+    key.reset();
+    QVERIFY(oldKey.isNull());
+    QWeakPointer<CompositeKey> currentKey = newKey;
+    newKey.reset();
+    reopened.reset();
+    db->releaseData();
+    QVERIFY(currentKey.isNull());
+}
+
+void TestDatabase::testTransformedKeyCache()
+{
+    TemporaryFile tempFile;
+    QVERIFY(tempFile.copyFromFile(dbFileName));
+
+    auto db = QSharedPointer<Database>::create();
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create("a"));
+
+    QString error;
+    QVERIFY(db->open(tempFile.fileName(), key, &error));
+
+    // Swap in a wrong key but keep the transformed key, a reload can only succeed if it is reused
+    auto wrongKey = QSharedPointer<CompositeKey>::create();
+    wrongKey->addKey(QSharedPointer<PasswordKey>::create("b"));
+    QVERIFY(db->setKey(wrongKey, false, false, false));
+
+    auto reloaded = QSharedPointer<Database>::create();
+    reloaded->setTransformedKeyCache(db.data());
+    QVERIFY2(reloaded->open(tempFile.fileName(), wrongKey, &error), error.toLatin1());
+    QCOMPARE(reloaded->transformedDatabaseKey(), db->transformedDatabaseKey());
+
+    reloaded = QSharedPointer<Database>::create();
+    QVERIFY(!reloaded->open(tempFile.fileName(), wrongKey, &error));
+
+    // Once the file is written with a different seed the cached key no longer applies
+    auto other = QSharedPointer<Database>::create();
+    QVERIFY2(other->open(tempFile.fileName(), key, &error), error.toLatin1());
+    other->metadata()->setName("changed");
+    QVERIFY2(other->save(Database::Atomic, {}, &error), error.toLatin1());
+    QVERIFY(other->kdf()->seed() != db->kdf()->seed());
+
+    reloaded = QSharedPointer<Database>::create();
+    reloaded->setTransformedKeyCache(db.data());
+    QVERIFY(!reloaded->open(tempFile.fileName(), wrongKey, &error));
+
+    reloaded = QSharedPointer<Database>::create();
+    reloaded->setTransformedKeyCache(other.data());
+    QVERIFY2(reloaded->open(tempFile.fileName(), key, &error), error.toLatin1());
+    QCOMPARE(reloaded->metadata()->name(), QString("changed"));
+}
+
+void TestDatabase::testReloadInPlace()
+{
+    auto clock = new MockClock(2010, 5, 5, 10, 30, 10);
+    MockClock::setup(clock);
+
+    TemporaryFile tempFile;
+    QVERIFY(tempFile.copyFromFile(dbFileName));
+
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create("a"));
+
+    QString error;
+    auto db = QSharedPointer<Database>::create();
+    QVERIFY(db->open(tempFile.fileName(), key, &error));
+
+    auto* groupA = new Group();
+    groupA->setUuid(QUuid::createUuid());
+    groupA->setName("A");
+    groupA->setParent(db->rootGroup());
+    auto* groupB = new Group();
+    groupB->setUuid(QUuid::createUuid());
+    groupB->setName("B");
+    groupB->setParent(db->rootGroup());
+
+    QList<Entry*> entries;
+    for (int i = 0; i < 4; ++i) {
+        auto* entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setTitle(QString("Entry %1").arg(i));
+        entry->setGroup(groupA);
+        entries << entry;
+    }
+    QVERIFY2(db->save(Database::Atomic, {}, &error), error.toLatin1());
+
+    // Another client changes, adds, moves and deletes entries
+    clock->advanceMinute(1);
+    auto other = QSharedPointer<Database>::create();
+    QVERIFY2(other->open(tempFile.fileName(), key, &error), error.toLatin1());
+    auto* otherEntry = other->rootGroup()->findEntryByUuid(entries[1]->uuid());
+    otherEntry->beginUpdate();
+    otherEntry->setTitle("Changed");
+    otherEntry->setTags("reloaded");
+    otherEntry->endUpdate();
+    auto* otherGroupB = other->rootGroup()->findGroupByUuid(groupB->uuid());
+    other->rootGroup()->findEntryByUuid(entries[2]->uuid())->setGroup(otherGroupB);
+    auto* newEntry = new Entry();
+    newEntry->setUuid(QUuid::createUuid());
+    newEntry->setTitle("New");
+    newEntry->setGroup(otherGroupB);
+    const QUuid deletedUuid = entries[3]->uuid();
+    delete other->rootGroup()->findEntryByUuid(deletedUuid);
+    QVERIFY2(other->save(Database::Atomic, {}, &error), error.toLatin1());
+
+    auto reloaded = QSharedPointer<Database>::create();
+    QVERIFY2(reloaded->open(tempFile.fileName(), key, &error), error.toLatin1());
+
+    QSignalSpy spyGroupAdded(db.data(), SIGNAL(groupAdded()));
+    QSignalSpy spyGroupRemoved(db.data(), SIGNAL(groupRemoved()));
+    QSignalSpy spyEntryDataChanged(entries[1], SIGNAL(entryDataChanged(Entry*)));
+    DatabaseDiff diff(reloaded.data(), db.data());
+    QVERIFY(diff.apply());
+    QVERIFY(diff.changes() >= 4);
+    QCOMPARE(spyGroupAdded.count(), 0);
+    QCOMPARE(spyGroupRemoved.count(), 0);
+    QVERIFY(spyEntryDataChanged.count() > 0);
+    QVERIFY(db->tagList().contains("reloaded"));
+    QVERIFY(!db->isModified());
+
+    // Existing items are updated in place
+    QCOMPARE(db->rootGroup()->children(), QList<Group*>({groupA, groupB}));
+    QCOMPARE(groupA->entries(), QList<Entry*>({entries[0], entries[1]}));
+    QCOMPARE(entries[1]->title(), QString("Changed"));
+    QCOMPARE(entries[1]->historyItems().size(), 1);
+    QCOMPARE(groupB->entries().size(), 2);
+    QCOMPARE(groupB->entries()[0], entries[2]);
+    QCOMPARE(groupB->entries()[1]->uuid(), newEntry->uuid());
+    QCOMPARE(groupB->entries()[1]->title(), QString("New"));
+    QVERIFY(!db->rootGroup()->findEntryByUuid(deletedUuid));
+    QVERIFY(db->containsDeletedObject(deletedUuid));
+
+    // Nothing is left to do afterwards
+    DatabaseDiff again(reloaded.data(), db.data());
+    QVERIFY(again.apply());
+    QCOMPARE(again.changes(), 0);
+
+    // Unrelated databases can not be reconciled
+    auto unrelated = QSharedPointer<Database>::create();
+    QVERIFY(!DatabaseDiff(unrelated.data(), db.data()).apply());
+
+    MockClock::teardown();
+}
+
 void TestDatabase::testSignals()
 {
     TemporaryFile tempFile;
@@ -166,6 +362,33 @@ void TestDatabase::testSignals()
     QCOMPARE(spyDiscarded.count(), 1);
 }
 
+void TestDatabase::testFileReplaced()
+{
+    TemporaryFile tempFile;
+    QVERIFY(tempFile.copyFromFile(dbFileName));
+
+    auto db = QSharedPointer<Database>::create();
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create("a"));
+
+    QString error;
+    QVERIFY(db->open(tempFile.fileName(), key, &error));
+
+    // Replace the file like an atomic save does, the watch must survive the first replacement
+    QSignalSpy spyFileChanged(db.data(), SIGNAL(databaseFileChanged()));
+    for (int i = 1; i <= 2; ++i) {
+        const QString replacementName = tempFile.fileName() + ".new";
+        QFile replacement(replacementName);
+        QVERIFY(replacement.open(QIODevice::WriteOnly));
+        replacement.write(QByteArray(2048, static_cast<char>(i)));
+        replacement.close();
+
+        QVERIFY(QFile::remove(tempFile.fileName()));
+        QVERIFY(QFile::rename(replacementName, tempFile.fileName()));
+        QTRY_COMPARE(spyFileChanged.count(), i);
+    }
+}
+
 void TestDatabase::testEmptyRecycleBinOnDisabled()
 {
     QString filename = QString(KEEPASSX_TEST_DATA_DIR).append("/RecycleBinDisabled.kdbx");
@@ -257,3 +480,63 @@ void TestDatabase::testCustomIcons()
     QCOMPARE(iconData.name, QString("Test"));
     QCOMPARE(iconData.lastModified, date);
 }
+
+void TestDatabase::testTagListAndUsernames()
+{
+    Database db;
+    QSignalSpy spyTagListUpdated(&db, SIGNAL(tagListUpdated()));
+
+    auto group = new Group();
+    group->setParent(db.rootGroup());
+
+    auto entry1 = new Entry();
+    entry1->setTags("b,a");
+    entry1->setUsername("alice");
+    entry1->setGroup(group);
+    QCOMPARE(db.tagList(), QStringList({"a", "b"}));
+    QCOMPARE(spyTagListUpdated.count(), 1);
+
+    auto entry2 = new Entry();
+    entry2->setGroup(db.rootGroup());
+    entry2->setUsername("bob");
+    entry2->setTags("a");
+    entry2->setUsername("carol");
+    // Changes that keep the set of tags don't trigger an update
+    QCOMPARE(spyTagListUpdated.count(), 1);
+    QCOMPARE(db.commonUsernames(), QStringList({"alice", "carol"}));
+
+    auto entry3 = new Entry();
+    entry3->setUsername("carol");
+    entry3->setGroup(db.rootGroup());
+    entry3->setTags("c");
+    QCOMPARE(db.tagList(), QStringList({"a", "b", "c"}));
+    QCOMPARE(spyTagListUpdated.count(), 2);
+    QCOMPARE(db.commonUsernames(), QStringList({"carol", "alice"}));
+
+    // Username references are not counted
+    entry1->setUsername(QString("{REF:U@I:%1}").arg(entry2->uuid().toString(QUuid::Id128)));
+    QCOMPARE(db.commonUsernames(), QStringList({"carol"}));
+
+    // Tags in the recycle bin are not listed, whether entries or groups are recycled
+    db.metadata()->setRecycleBinEnabled(true);
+    db.recycleEntry(entry3);
+    QCOMPARE(db.tagList(), QStringList({"a", "b"}));
+    QCOMPARE(spyTagListUpdated.count(), 3);
+    db.recycleGroup(group);
+    QCOMPARE(db.tagList(), QStringList({"a"}));
+    QCOMPARE(spyTagListUpdated.count(), 4);
+
+    entry2->removeTag("a");
+    QCOMPARE(db.tagList(), QStringList());
+    QCOMPARE(spyTagListUpdated.count(), 5);
+
+    // A full rescan agrees with the incremental state
+    db.updateTagList();
+    QCOMPARE(db.tagList(), QStringList());
+    QCOMPARE(spyTagListUpdated.count(), 5);
+
+    delete entry2;
+    QCOMPARE(db.commonUsernames(), QStringList({"carol"}));
+    db.emptyRecycleBin();
+    QCOMPARE(db.commonUsernames(), QStringList());
+}
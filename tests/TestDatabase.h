@@ -30,12 +30,17 @@ private slots:
     void testOpen();
     void testSave();
     void testSaveAs();
+    void testKeyPrecomputation();
+    void testTransformedKeyCache();
+    void testReloadInPlace();
     void testSignals();
+    void testFileReplaced();
     void testEmptyRecycleBinOnDisabled();
     void testEmptyRecycleBinOnNotCreated();
     void testEmptyRecycleBinOnEmpty();
     void testEmptyRecycleBinWithHierarchicalData();
     void testCustomIcons();
+    void testTagListAndUsernames();
 };
 
 #endif // KEEPASSX_TESTDATABASE_H
@@ -16,6 +16,7 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <QDir>
 #include <QTest>
 
 #include "TestEntry.h"
@@ -589,6 +590,77 @@ void TestEntry::testResolveClonedEntry()
     QCOMPARE(cclone4->resolveMultiplePlaceholders(cclone4->password()), original->password());
 }
 
+void TestEntry::testReferenceIndex()
+{
+    Database db;
+    auto* root = db.rootGroup();
+    auto* group = new Group();
+    group->setParent(root);
+
+    auto* target = new Entry();
+    target->setGroup(root);
+    target->setUuid(QUuid::createUuid());
+    target->setTitle("target");
+    target->setUsername("alice");
+
+    auto* byUuid = new Entry();
+    byUuid->setGroup(root);
+    byUuid->setUuid(QUuid::createUuid());
+    byUuid->setUsername(QString("{REF:U@I:%1}").arg(target->uuidToHex()));
+
+    auto* byTitle = new Entry();
+    byTitle->setGroup(group);
+    byTitle->setUuid(QUuid::createUuid());
+    byTitle->setNotes("{REF:U@T:target}");
+
+    QCOMPARE(byUuid->resolveMultiplePlaceholders(byUuid->username()), QString("alice"));
+    QCOMPARE(byTitle->resolveMultiplePlaceholders(byTitle->notes()), QString("alice"));
+
+    // Cached values are dropped when the referenced entry changes
+    target->setUsername("bob");
+    QCOMPARE(byUuid->resolveMultiplePlaceholders(byUuid->username()), QString("bob"));
+    QCOMPARE(byTitle->resolveMultiplePlaceholders(byTitle->notes()), QString("bob"));
+
+    target->setTitle("renamed");
+    QCOMPARE(byTitle->resolveMultiplePlaceholders(byTitle->notes()), QString());
+    QCOMPARE(byUuid->resolvePlaceholder(byUuid->username()), QString("bob"));
+
+    // The first entry in tree order wins
+    auto* duplicate = new Entry();
+    duplicate->setGroup(group);
+    duplicate->setUuid(QUuid::createUuid());
+    duplicate->setTitle("renamed");
+    duplicate->setUsername("carol");
+    QCOMPARE(byTitle->resolveMultiplePlaceholders(byTitle->notes()), QString());
+    byTitle->setNotes("{REF:U@T:renamed}");
+    QCOMPARE(byTitle->resolveMultiplePlaceholders(byTitle->notes()), QString("bob"));
+    delete target;
+    QCOMPARE(byTitle->resolveMultiplePlaceholders(byTitle->notes()), QString("carol"));
+
+    // Reverse references
+    QCOMPARE(root->referencesRecursive(duplicate), QList<Entry*>());
+    byUuid->setPassword(QString("{REF:P@I:%1}").arg(duplicate->uuidToHex().toUpper()));
+    byTitle->setUrl(QString("{REF:A@I:%1}").arg(duplicate->uuidToHex()));
+    QCOMPARE(root->referencesRecursive(duplicate), QList<Entry*>() << byUuid << byTitle);
+    QCOMPARE(group->referencesRecursive(duplicate), QList<Entry*>() << byTitle);
+
+    // Values depending on the environment are not cached
+    db.setFilePath(QDir::tempPath() + "/one/db.kdbx");
+    QCOMPARE(byUuid->resolvePlaceholder("{DB_DIR}"), QDir::tempPath() + "/one");
+    db.setFilePath(QDir::tempPath() + "/two/db.kdbx");
+    QCOMPARE(byUuid->resolvePlaceholder("{DB_DIR}"), QDir::tempPath() + "/two");
+
+    // Resolved passwords do not outlive the unlocked database
+    duplicate->setPassword("secret");
+    const QString passwordReference = byUuid->password();
+    QCOMPARE(byUuid->resolveMultiplePlaceholders(passwordReference), QString("secret"));
+    QString cached;
+    QVERIFY(db.referenceIndex()->resolvedValue(byUuid, passwordReference, true, cached));
+    const Entry* resolvedEntry = byUuid;
+    db.releaseData();
+    QVERIFY(!db.referenceIndex()->resolvedValue(resolvedEntry, passwordReference, true, cached));
+}
+
 void TestEntry::testIsRecycled()
 {
     auto entry = new Entry();
@@ -768,3 +840,112 @@ void TestEntry::testPreviousParentGroup()
     QVERIFY(entry->previousParentGroupUuid() == group1->uuid());
     QVERIFY(entry->previousParentGroup() == group1);
 }
+
+void TestEntry::testShareHistoryData()
+{
+    // Build every revision from separately allocated strings, like the KDBX reader does
+    auto makeRevision = [](const QString& title, const QString& notes, const QByteArray& attachment) {
+        auto entry = new Entry();
+        entry->setUpdateTimeinfo(false);
+        entry->setTitle(QString(title.constData(), title.size()));
+        entry->setNotes(QString(notes.constData(), notes.size()));
+        entry->attributes()->set("Custom", QString("custom").repeated(10), true);
+        entry->attachments()->set("file", QByteArray(attachment.constData(), attachment.size()));
+        return entry;
+    };
+
+    const QString longNotes = QString("notes").repeated(1000);
+    const QByteArray attachment(4096, 'a');
+    QScopedPointer<Entry> entry(makeRevision("Title 3", longNotes + "!", attachment));
+    entry->addHistoryItem(makeRevision("Title 1", longNotes, attachment));
+    entry->addHistoryItem(makeRevision("Title 2", longNotes, attachment));
+
+    const auto history = entry->historyItems();
+    QVERIFY(history[0]->notes().constData() != history[1]->notes().constData());
+    QVERIFY(history[1]->notes().constData() != entry->notes().constData());
+
+    entry->shareHistoryData();
+
+    // values are unchanged
+    QCOMPARE(history[0]->title(), QString("Title 1"));
+    QCOMPARE(history[1]->title(), QString("Title 2"));
+    QCOMPARE(entry->title(), QString("Title 3"));
+    QCOMPARE(history[0]->notes(), longNotes);
+    QCOMPARE(history[1]->notes(), longNotes);
+    QCOMPARE(entry->notes(), longNotes + "!");
+    QVERIFY(history[0]->attributes()->isProtected("Custom"));
+
+    // values that are equal to the next newer revision share their storage
+    QCOMPARE(history[0]->notes().constData(), history[1]->notes().constData());
+    QVERIFY(history[1]->notes().constData() != entry->notes().constData());
+    QCOMPARE(history[0]->attributes()->value("Custom").constData(),
+             entry->attributes()->value("Custom").constData());
+    QCOMPARE(history[0]->attachments()->value("file").constData(), entry->attachments()->value("file").constData());
+
+    // modifying a history item copies the value and leaves the others alone
+    history[0]->setNotes("changed");
+    QCOMPARE(history[0]->notes(), QString("changed"));
+    QCOMPARE(history[1]->notes(), longNotes);
+}
+
+void TestEntry::testSize()
+{
+    Entry entry;
+    const int emptySize = entry.size();
+
+    entry.setTitle("title");
+    QCOMPARE(entry.size(), emptySize + 5);
+    entry.setTitle("t");
+    QCOMPARE(entry.size(), emptySize + 1);
+
+    entry.attributes()->set("key", "value");
+    QCOMPARE(entry.size(), emptySize + 1 + 8);
+    entry.attributes()->rename("key", "k");
+    QCOMPARE(entry.size(), emptySize + 1 + 6);
+    entry.attributes()->remove("k");
+    QCOMPARE(entry.size(), emptySize + 1);
+
+    // The first custom attribute is added without removing any
+    Entry withCustomKey;
+    withCustomKey.attributes()->set("key", "value");
+    entry.attributes()->copyCustomKeysFrom(withCustomKey.attributes());
+    QCOMPARE(entry.size(), emptySize + 1 + 8);
+    entry.attributes()->copyCustomKeysFrom(Entry().attributes());
+    QCOMPARE(entry.size(), emptySize + 1);
+
+    entry.attachments()->set("file", QByteArray(100, 'a'));
+    QCOMPARE(entry.size(), emptySize + 1 + 104);
+    entry.attachments()->remove("file");
+    QCOMPARE(entry.size(), emptySize + 1);
+
+    entry.customData()->set("data", "value");
+    const int customDataSize = entry.customData()->dataSize();
+    QVERIFY(customDataSize >= 9);
+    QCOMPARE(entry.size(), emptySize + 1 + customDataSize);
+    entry.customData()->clear();
+    QCOMPARE(entry.size(), emptySize + 1);
+
+    entry.autoTypeAssociations()->add({"window", "{USERNAME}"});
+    QCOMPARE(entry.size(), emptySize + 1 + 16);
+    entry.autoTypeAssociations()->remove(0);
+    QCOMPARE(entry.size(), emptySize + 1);
+
+    entry.setTags("tag1;tag2");
+    QCOMPARE(entry.size(), emptySize + 1 + 8);
+    entry.addTag("a:b");
+    QCOMPARE(entry.size(), emptySize + 1 + 10);
+    entry.removeTag("tag1");
+    QCOMPARE(entry.size(), emptySize + 1 + 6);
+
+    QScopedPointer<Entry> other(new Entry());
+    other->setTitle("other title");
+    entry.copyDataFrom(other.data());
+    QCOMPARE(entry.size(), other->size());
+
+    QCOMPARE(entry.historySize(), 0);
+    entry.addHistoryItem(other->clone(Entry::CloneNoFlags));
+    entry.addHistoryItem(other->clone(Entry::CloneNoFlags));
+    QCOMPARE(entry.historySize(), 2 * other->size());
+    entry.removeHistoryItems({entry.historyItems().first()});
+    QCOMPARE(entry.historySize(), other->size());
+}
@@ -37,9 +37,12 @@ private slots:
     void testResolveReferencePlaceholders();
     void testResolveNonIdPlaceholdersToUuid();
     void testResolveClonedEntry();
+    void testReferenceIndex();
     void testIsRecycled();
     void testMoveUpDown();
     void testPreviousParentGroup();
+    void testShareHistoryData();
+    void testSize();
 };
 
 #endif // KEEPASSX_TESTENTRY_H
@@ -376,3 +376,47 @@ void TestEntryModel::testDatabaseDelete()
     delete modelTest;
     delete model;
 }
+
+void TestEntryModel::testAppendEntries()
+{
+    auto model = new EntryModel(this);
+    auto modelTest = new ModelTest(model, this);
+
+    auto db = new Database();
+    auto group1 = new Group();
+    group1->setParent(db->rootGroup());
+    auto group2 = new Group();
+    group2->setParent(db->rootGroup());
+
+    auto entry1 = new Entry();
+    entry1->setGroup(group1);
+    auto entry2 = new Entry();
+    entry2->setGroup(group2);
+    auto entry3 = new Entry();
+    entry3->setGroup(group2);
+
+    model->setEntries(QList<Entry*>() << entry1);
+
+    QSignalSpy spyAboutToAdd(model, SIGNAL(rowsAboutToBeInserted(QModelIndex, int, int)));
+    QSignalSpy spyAdded(model, SIGNAL(rowsInserted(QModelIndex, int, int)));
+
+    model->appendEntries(QList<Entry*>() << entry2 << entry3);
+    QCOMPARE(spyAboutToAdd.count(), 1);
+    QCOMPARE(spyAdded.count(), 1);
+    QCOMPARE(spyAdded.first().at(1).toInt(), 1);
+    QCOMPARE(spyAdded.first().at(2).toInt(), 2);
+    QCOMPARE(model->rowCount(), 3);
+    QCOMPARE(model->entryFromIndex(model->index(2, 0)), entry3);
+
+    // Appended entries are tracked like the initial ones
+    QSignalSpy spyDataChanged(model, SIGNAL(dataChanged(QModelIndex, QModelIndex)));
+    entry2->setTitle("changed");
+    QVERIFY(!spyDataChanged.isEmpty());
+
+    delete entry3;
+    QCOMPARE(model->rowCount(), 2);
+
+    delete modelTest;
+    delete model;
+    delete db;
+}
@@ -16,13 +16,20 @@
  */
 
 #include "TestEntrySearcher.h"
+#include "core/Database.h"
 #include "core/Group.h"
 #include "core/Tools.h"
+#include "crypto/Crypto.h"
 
 #include <QTest>
 
 QTEST_GUILESS_MAIN(TestEntrySearcher)
 
+void TestEntrySearcher::initTestCase()
+{
+    QVERIFY(Crypto::init());
+}
+
 void TestEntrySearcher::init()
 {
     m_rootGroup = new Group();
@@ -394,3 +401,116 @@ void TestEntrySearcher::testUUIDSearch()
     m_searchResult = m_entrySearcher.search("uuid:" + Tools::uuidToHex(uuid1), m_rootGroup);
     QCOMPARE(m_searchResult.count(), 1);
 }
+
+void TestEntrySearcher::testSearchIndex()
+{
+    Database db;
+    db.setSearchIndexEnabled(true);
+    QVERIFY(db.searchIndex());
+
+    auto group = new Group();
+    group->setParent(db.rootGroup());
+
+    auto entry1 = new Entry();
+    entry1->setUuid(QUuid::createUuid());
+    entry1->setGroup(group);
+    entry1->setTitle("Banking Portal");
+    entry1->setUsername("alice");
+    entry1->setUrl("https://bank.example.com");
+    entry1->setTags("finance;work");
+
+    auto entry2 = new Entry();
+    entry2->setGroup(db.rootGroup());
+    entry2->setTitle("Email");
+    entry2->setUsername("Alice.Smith");
+    entry2->setNotes("Recovery codes are in the safe");
+    entry2->attributes()->set("Department", "Accounting");
+
+    // Title is resolved from another entry, it must always be searched
+    auto entry3 = new Entry();
+    entry3->setGroup(db.rootGroup());
+    entry3->setUuid(QUuid::createUuid());
+    entry3->setTitle(QString("{REF:T@I:%1}").arg(entry1->uuidToHex()));
+
+    EntrySearcher searcher;
+    auto search = [&](const QString& query) { return searcher.search(query, db.rootGroup()); };
+
+    QCOMPARE(search("bank"), QList<Entry*>() << entry3 << entry1);
+    QCOMPARE(search("ALICE"), QList<Entry*>() << entry2 << entry1);
+    QCOMPARE(search("recovery"), QList<Entry*>() << entry2);
+    QCOMPARE(search("tag:finance"), QList<Entry*>() << entry1);
+    QCOMPARE(search("attr:accounting"), QList<Entry*>() << entry2);
+    QCOMPARE(search("ba*ing"), QList<Entry*>() << entry3 << entry1);
+    QCOMPARE(search("email|portal"), QList<Entry*>() << entry2 << entry3 << entry1);
+    QCOMPARE(search("-alice"), QList<Entry*>() << entry3);
+    QVERIFY(search("nonexistent").isEmpty());
+
+    // Modified entries are re-indexed
+    entry2->setTitle("Mailbox");
+    QVERIFY(search("email").isEmpty());
+    QCOMPARE(search("mailbox"), QList<Entry*>() << entry2);
+
+    // Moved and deleted entries
+    entry2->setGroup(group);
+    QCOMPARE(search("mailbox"), QList<Entry*>() << entry2);
+    delete entry2;
+    QVERIFY(search("mailbox").isEmpty());
+
+    // Results are the same without the index
+    db.setSearchIndexEnabled(false);
+    QVERIFY(!db.searchIndex());
+    QCOMPARE(search("bank"), QList<Entry*>() << entry3 << entry1);
+    db.setSearchIndexEnabled(true);
+    QCOMPARE(search("bank"), QList<Entry*>() << entry3 << entry1);
+}
+
+void TestEntrySearcher::testFilterEntriesInChunks()
+{
+    for (int i = 0; i < 100; ++i) {
+        auto entry = new Entry();
+        entry->setGroup(m_rootGroup);
+        entry->setTitle(QString("Entry %1").arg(i));
+        entry->setUsername(i % 3 == 0 ? "fizz" : "buzz");
+    }
+
+    auto expected = m_entrySearcher.search("fizz", m_rootGroup);
+    QCOMPARE(expected.size(), 34);
+
+    auto entries = m_entrySearcher.collectEntries("fizz", m_rootGroup);
+    QCOMPARE(entries.size(), 100);
+
+    // Matching in chunks yields the same results in the same order
+    QList<Entry*> results;
+    for (int i = 0; i < entries.size(); i += 30) {
+        results.append(m_entrySearcher.filterEntries(entries.mid(i, 30)));
+    }
+    QCOMPARE(results, expected);
+}
+
+void TestEntrySearcher::benchmarkSearchIndex()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    Database db;
+    db.setSearchIndexEnabled(true);
+    for (int i = 0; i < 50000; ++i) {
+        auto entry = new Entry();
+        entry->setGroup(db.rootGroup());
+        entry->setTitle(QString("Entry %1").arg(i));
+        entry->setUsername(QString("user%1@example.com").arg(i));
+        entry->setUrl(QString("https://site%1.example.com/login").arg(i));
+        entry->setNotes(QString("Notes for entry number %1").arg(i));
+    }
+
+    EntrySearcher searcher;
+    // Build the index outside of the measurement
+    QCOMPARE(searcher.search("user4242@", db.rootGroup()).size(), 1);
+
+    QBENCHMARK
+    {
+        searcher.search("user4242@", db.rootGroup());
+    }
+}
@@ -554,6 +554,70 @@ void TestGroup::testFindEntry()
     QVERIFY(!entry);
 }
 
+void TestGroup::testFindByUuidIndex()
+{
+    QScopedPointer<Database> db1(new Database());
+    QScopedPointer<Database> db2(new Database());
+
+    auto group = new Group();
+    group->setUuid(QUuid::createUuid());
+    auto subGroup = new Group();
+    subGroup->setUuid(QUuid::createUuid());
+    subGroup->setParent(group);
+    auto entry = new Entry();
+    entry->setUuid(QUuid::createUuid());
+    entry->setGroup(subGroup);
+
+    // Nothing is indexed before the tree is attached to a database
+    QCOMPARE(group->findEntryByUuid(entry->uuid(), true), entry);
+    QVERIFY(!db1->rootGroup()->findEntryByUuid(entry->uuid()));
+
+    group->setParent(db1->rootGroup());
+    QCOMPARE(db1->rootGroup()->findEntryByUuid(entry->uuid()), entry);
+    QCOMPARE(db1->rootGroup()->findGroupByUuid(subGroup->uuid()), subGroup);
+    QCOMPARE(subGroup->findEntryByUuid(entry->uuid(), false), entry);
+    QVERIFY(!group->findEntryByUuid(entry->uuid(), false));
+    QVERIFY(!subGroup->findGroupByUuid(group->uuid()));
+
+    // Changing the UUID updates the index
+    const QUuid oldUuid = entry->uuid();
+    entry->setUuid(QUuid::createUuid());
+    QVERIFY(!db1->rootGroup()->findEntryByUuid(oldUuid));
+    QCOMPARE(db1->rootGroup()->findEntryByUuid(entry->uuid()), entry);
+
+    const QUuid oldGroupUuid = subGroup->uuid();
+    subGroup->setUuid(QUuid::createUuid());
+    QVERIFY(!db1->rootGroup()->findGroupByUuid(oldGroupUuid));
+    QCOMPARE(db1->rootGroup()->findGroupByUuid(subGroup->uuid()), subGroup);
+
+    // Moving a group to another database moves its index entries
+    group->setParent(db2->rootGroup());
+    QVERIFY(!db1->rootGroup()->findEntryByUuid(entry->uuid()));
+    QVERIFY(!db1->rootGroup()->findGroupByUuid(subGroup->uuid()));
+    QCOMPARE(db2->rootGroup()->findEntryByUuid(entry->uuid()), entry);
+    QCOMPARE(db2->rootGroup()->findGroupByUuid(subGroup->uuid()), subGroup);
+
+    // Moving a single entry between databases
+    entry->setGroup(db1->rootGroup());
+    QVERIFY(!db2->rootGroup()->findEntryByUuid(entry->uuid()));
+    QCOMPARE(db1->rootGroup()->findEntryByUuid(entry->uuid()), entry);
+
+    // Clones share UUIDs, only the one below the searched group is returned
+    auto clone = entry->clone(Entry::CloneNoFlags);
+    clone->setGroup(group);
+    QCOMPARE(db1->rootGroup()->findEntryByUuid(entry->uuid()), entry);
+    QCOMPARE(db2->rootGroup()->findEntryByUuid(entry->uuid()), clone);
+
+    // Deleted objects are removed from the index
+    const QUuid entryUuid = entry->uuid();
+    const QUuid subGroupUuid = subGroup->uuid();
+    delete entry;
+    delete subGroup;
+    QVERIFY(!db1->rootGroup()->findEntryByUuid(entryUuid));
+    QVERIFY(!db2->rootGroup()->findGroupByUuid(subGroupUuid));
+    QCOMPARE(db2->rootGroup()->findEntryByUuid(entryUuid), clone);
+}
+
 void TestGroup::testFindGroupByPath()
 {
     QScopedPointer<Database> db(new Database());
@@ -38,6 +38,7 @@ private slots:
     void testCopyCustomIcons();
     void testFindEntry();
     void testFindGroupByPath();
+    void testFindByUuidIndex();
     void testPrint();
     void testAddEntryWithPath();
     void testIsRecycled();
@@ -24,6 +24,7 @@
 #include <QBuffer>
 #include <QByteArray>
 #include <QList>
+#include <QTemporaryFile>
 #include <QTest>
 
 QTEST_GUILESS_MAIN(TestHibp)
@@ -31,6 +32,13 @@ QTEST_GUILESS_MAIN(TestHibp)
 const char* TEST_HIBP_CONTENTS = "0BEEC7B5EA3F0FDBC95D0DD47F3C5BC275DA8A33:123\n" // SHA-1 of "foo"
                                  "62cdb7020ff920e5aa642c3d4066950dd1f01f4d:456\n"; // SHA-1 of "bar"
 
+const char* TEST_SORTED_HIBP_CONTENTS = "000000005AD76BD555C1D6D771DE417A4B87E4B4:4\r\n"
+                                        "0BEEC7B5EA3F0FDBC95D0DD47F3C5BC275DA8A33:123\r\n" // SHA-1 of "foo"
+                                        "2AB96390C7DBE3439DE74D0C9B0B17670C1A3B2D:1\r\n"
+                                        "5F9C6D4EA1B5A2F0B1F6B0A2E3C7C5D1E0F9A8B7:9\r\n"
+                                        "62cdb7020ff920e5aa642c3d4066950dd1f01f4d:456\r\n" // SHA-1 of "bar"
+                                        "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF:7";
+
 const char* TEST_BAD_HIBP_CONTENTS = "barf:nope\n";
 
 void TestHibp::initTestCase()
@@ -118,3 +126,83 @@ void TestHibp::testPwned()
     QCOMPARE(findings[1].first, entry4);
     QCOMPARE(findings[1].second, 456);
 }
+
+void TestHibp::testMappedPwned()
+{
+    QTemporaryFile hibpFile;
+    QVERIFY(hibpFile.open());
+    QVERIFY(hibpFile.write(TEST_SORTED_HIBP_CONTENTS) > 0);
+    QVERIFY(hibpFile.flush());
+
+    Group* root = m_db->rootGroup();
+
+    auto entry1 = new Entry();
+    entry1->setPassword("bar");
+    entry1->setGroup(root);
+
+    auto entry2 = new Entry();
+    entry2->setPassword("xyz");
+    entry2->setGroup(root);
+
+    auto entry3 = new Entry();
+    entry3->setPassword("foo");
+    m_db->recycleEntry(entry3);
+
+    auto entry4 = new Entry();
+    entry4->setPassword("foo");
+    entry4->setGroup(root);
+
+    auto entry5 = new Entry();
+    entry5->setPassword("bar");
+    entry5->setGroup(root);
+
+    QList<QPair<const Entry*, int>> findings;
+    QString error;
+    QVERIFY(HibpOffline::mappedReport(m_db, hibpFile, findings, &error));
+    QCOMPARE(error, QString());
+    // Findings are ordered by hash
+    QCOMPARE(findings.size(), 3);
+    QCOMPARE(findings[0].first, entry4);
+    QCOMPARE(findings[0].second, 123);
+    QCOMPARE(findings[1].first, entry1);
+    QCOMPARE(findings[1].second, 456);
+    QCOMPARE(findings[2].first, entry5);
+    QCOMPARE(findings[2].second, 456);
+}
+
+void TestHibp::testMappedUnordered()
+{
+    QTemporaryFile hibpFile;
+    QVERIFY(hibpFile.open());
+    QVERIFY(hibpFile.write(QByteArray(TEST_HIBP_CONTENTS).prepend("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF:7\n"))
+            > 0);
+    QVERIFY(hibpFile.flush());
+
+    auto entry = new Entry();
+    entry->setPassword("foo");
+    entry->setGroup(m_db->rootGroup());
+
+    // Not ordered by hash, the caller has to fall back to a full scan
+    QList<QPair<const Entry*, int>> findings;
+    QString error;
+    QVERIFY(!HibpOffline::mappedReport(m_db, hibpFile, findings, &error));
+    QCOMPARE(error, QString());
+    QCOMPARE(findings.size(), 0);
+
+    QVERIFY(hibpFile.seek(0));
+    QVERIFY(HibpOffline::report(m_db, hibpFile, findings, &error));
+    QCOMPARE(findings.size(), 1);
+    QCOMPARE(findings[0].first, entry);
+    QCOMPARE(findings[0].second, 123);
+
+    // Malformed files are reported as errors
+    QTemporaryFile badFile;
+    QVERIFY(badFile.open());
+    QVERIFY(badFile.write(TEST_BAD_HIBP_CONTENTS) > 0);
+    QVERIFY(badFile.flush());
+
+    findings.clear();
+    QVERIFY(!HibpOffline::mappedReport(m_db, badFile, findings, &error));
+    QVERIFY(!error.isEmpty());
+    QCOMPARE(findings.size(), 0);
+}
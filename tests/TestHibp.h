@@ -34,6 +34,8 @@ private slots:
     void testEmpty();
     void testIoError();
     void testPwned();
+    void testMappedPwned();
+    void testMappedUnordered();
 
 private:
     QSharedPointer<Database> m_db;
@@ -18,17 +18,25 @@
 #include "TestKdbx4.h"
 
 #include "config-keepassx-tests.h"
+#include "core/Group.h"
 #include "core/Metadata.h"
+#include "crypto/Random.h"
+#include "format/Kdbx4Reader.h"
 #include "format/KdbxXmlReader.h"
+#include "format/Kdbx4Writer.h"
 #include "format/KdbxXmlWriter.h"
 #include "format/KeePass2.h"
+#include "format/KeePass2RandomStream.h"
 #include "format/KeePass2Reader.h"
 #include "format/KeePass2Writer.h"
 #include "keys/FileKey.h"
 #include "keys/PasswordKey.h"
 #include "mock/MockChallengeResponseKey.h"
 #include "mock/MockClock.h"
+#include "mock/MockRandom.h"
+#include "streams/PipelineStream.h"
 #include <QTest>
+#include <QThread>
 
 int main(int argc, char* argv[])
 {
@@ -510,3 +518,321 @@ void TestKdbx4Format::testCustomData()
     QCOMPARE(newEntry->customData()->value(customDataKey1), customData1);
     QCOMPARE(newEntry->customData()->value(customDataKey2), customData2);
 }
+
+QSharedPointer<Database> TestKdbx4Format::createLargeDatabase(int entryCount) const
+{
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create("test"));
+
+    auto db = QSharedPointer<Database>::create();
+    db->changeKdf(fastKdf(KeePass2::uuidToKdf(KeePass2::KDF_ARGON2D)));
+    db->setKey(key);
+
+    for (int i = 0; i < entryCount; ++i) {
+        auto entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setTitle(QString("Entry %1").arg(i));
+        entry->setUsername(QString("user%1@example.com").arg(i));
+        entry->setPassword(QString::fromLatin1(randomGen()->randomArray(24).toHex()));
+        entry->setUrl(QString("https://www%1.example.com/login").arg(i));
+        entry->setNotes(QString("Notes for entry %1").arg(i).repeated(8));
+        entry->setGroup(db->rootGroup());
+    }
+
+    // incompressible attachment to make sure the payload spans several HMAC blocks
+    auto entry = new Entry();
+    entry->setUuid(QUuid::createUuid());
+    entry->setTitle("Attachment");
+    entry->attachments()->set("random.bin", randomGen()->randomArray(3 * 1024 * 1024));
+    entry->setGroup(db->rootGroup());
+
+    return db;
+}
+
+void TestKdbx4Format::testPipelinedRead_data()
+{
+    QTest::addColumn<QUuid>("cipher");
+    QTest::addColumn<bool>("compressed");
+
+    QTest::newRow("AES256 compressed") << KeePass2::CIPHER_AES256 << true;
+    QTest::newRow("AES256 uncompressed") << KeePass2::CIPHER_AES256 << false;
+    QTest::newRow("Twofish compressed") << KeePass2::CIPHER_TWOFISH << true;
+    QTest::newRow("ChaCha20 compressed") << KeePass2::CIPHER_CHACHA20 << true;
+    QTest::newRow("ChaCha20 uncompressed") << KeePass2::CIPHER_CHACHA20 << false;
+}
+
+void TestKdbx4Format::testPipelinedRead()
+{
+    QFETCH(QUuid, cipher);
+    QFETCH(bool, compressed);
+
+    auto db = createLargeDatabase(500);
+    db->setCipher(cipher);
+    db->setCompressionAlgorithm(compressed ? Database::CompressionGZip : Database::CompressionNone);
+
+    QBuffer buffer;
+    buffer.open(QBuffer::ReadWrite);
+    KeePass2Writer writer;
+    QVERIFY(writer.writeDatabase(&buffer, db.data()));
+
+    auto serialDb = QSharedPointer<Database>::create();
+    Kdbx4Reader serialReader;
+    serialReader.setPipelined(false);
+    QVERIFY(serialReader.readDatabase(&buffer, db->key(), serialDb.data()));
+    QVERIFY(!serialReader.hasError());
+
+    auto pipelinedDb = QSharedPointer<Database>::create();
+    Kdbx4Reader pipelinedReader;
+    pipelinedReader.setPipelined(true);
+    QVERIFY(pipelinedReader.readDatabase(&buffer, db->key(), pipelinedDb.data()));
+    QVERIFY(!pipelinedReader.hasError());
+
+    auto serialEntries = serialDb->rootGroup()->entriesRecursive();
+    auto pipelinedEntries = pipelinedDb->rootGroup()->entriesRecursive();
+    QCOMPARE(pipelinedEntries.size(), db->rootGroup()->entriesRecursive().size());
+    QCOMPARE(pipelinedEntries.size(), serialEntries.size());
+    for (int i = 0; i < serialEntries.size(); ++i) {
+        QCOMPARE(pipelinedEntries[i]->uuid(), serialEntries[i]->uuid());
+        QCOMPARE(pipelinedEntries[i]->password(), serialEntries[i]->password());
+        QCOMPARE(pipelinedEntries[i]->attachments()->values(), serialEntries[i]->attachments()->values());
+    }
+
+    // a corrupted block must be reported, not silently truncated
+    auto corruptPos = static_cast<int>(buffer.size()) - 1024 * 1024;
+    buffer.buffer()[corruptPos] = static_cast<char>(~buffer.buffer().at(corruptPos));
+    auto corruptDb = QSharedPointer<Database>::create();
+    Kdbx4Reader corruptReader;
+    corruptReader.setPipelined(true);
+    QVERIFY(!corruptReader.readDatabase(&buffer, db->key(), corruptDb.data()));
+    QVERIFY(corruptReader.hasError());
+}
+
+void TestKdbx4Format::benchmarkPipelinedRead_data()
+{
+    QTest::addColumn<bool>("pipelined");
+
+    QTest::newRow("serial") << false;
+    QTest::newRow(qPrintable(QString("pipelined (%1 cores)").arg(QThread::idealThreadCount()))) << true;
+}
+
+void TestKdbx4Format::benchmarkPipelinedRead()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QFETCH(bool, pipelined);
+
+    auto db = createLargeDatabase(50000);
+    QBuffer buffer;
+    buffer.open(QBuffer::ReadWrite);
+    KeePass2Writer writer;
+    QVERIFY(writer.writeDatabase(&buffer, db.data()));
+
+    QBENCHMARK
+    {
+        auto newDb = QSharedPointer<Database>::create();
+        Kdbx4Reader reader;
+        reader.setPipelined(pipelined);
+        QVERIFY(reader.readDatabase(&buffer, db->key(), newDb.data()));
+    }
+}
+
+void TestKdbx4Format::testPipelinedWrite_data()
+{
+    QTest::addColumn<QUuid>("cipher");
+    QTest::addColumn<bool>("compressed");
+
+    QTest::newRow("AES256 compressed") << KeePass2::CIPHER_AES256 << true;
+    QTest::newRow("AES256 uncompressed") << KeePass2::CIPHER_AES256 << false;
+    QTest::newRow("Twofish compressed") << KeePass2::CIPHER_TWOFISH << true;
+    QTest::newRow("ChaCha20 compressed") << KeePass2::CIPHER_CHACHA20 << true;
+    QTest::newRow("ChaCha20 uncompressed") << KeePass2::CIPHER_CHACHA20 << false;
+}
+
+void TestKdbx4Format::testPipelinedWrite()
+{
+    QFETCH(QUuid, cipher);
+    QFETCH(bool, compressed);
+
+    // the pipeline must pass data on unchanged, regardless of how it is split up
+    QByteArray data = randomGen()->randomArray(100000);
+    QBuffer pipeBuffer;
+    pipeBuffer.open(QBuffer::WriteOnly);
+    PipelineStream pipeline(&pipeBuffer, 4096, 2);
+    QVERIFY(pipeline.open(QIODevice::WriteOnly));
+    for (int pos = 0, size = 1; pos < data.size(); pos += size, size = size * 3 % 10007) {
+        size = qMin(size, data.size() - pos);
+        QCOMPARE(pipeline.write(data.constData() + pos, size), static_cast<qint64>(size));
+    }
+    QVERIFY(pipeline.reset());
+    QCOMPARE(pipeBuffer.data(), data);
+    pipeline.close();
+
+    auto db = createLargeDatabase(500);
+    db->setCipher(cipher);
+    db->setCompressionAlgorithm(compressed ? Database::CompressionGZip : Database::CompressionNone);
+    db->setFormatVersion(KeePass2Writer::kdbxVersionRequired(db.data()));
+
+    QBuffer buffer;
+    buffer.open(QBuffer::ReadWrite);
+    Kdbx4Writer writer;
+    writer.setPipelined(true);
+    QVERIFY(writer.writeDatabase(&buffer, db.data()));
+    QVERIFY(!writer.hasError());
+
+    buffer.seek(0);
+    auto newDb = QSharedPointer<Database>::create();
+    KeePass2Reader reader;
+    QVERIFY(reader.readDatabase(&buffer, db->key(), newDb.data()));
+    QVERIFY(!reader.hasError());
+
+    auto entries = db->rootGroup()->entriesRecursive();
+    auto newEntries = newDb->rootGroup()->entriesRecursive();
+    QCOMPARE(newEntries.size(), entries.size());
+    for (int i = 0; i < entries.size(); ++i) {
+        QCOMPARE(newEntries[i]->uuid(), entries[i]->uuid());
+        QCOMPARE(newEntries[i]->password(), entries[i]->password());
+        QCOMPARE(newEntries[i]->notes(), entries[i]->notes());
+        QCOMPARE(newEntries[i]->attachments()->values(), entries[i]->attachments()->values());
+    }
+}
+
+void TestKdbx4Format::testPipelinedWriteIdentical_data()
+{
+    testPipelinedWrite_data();
+}
+
+void TestKdbx4Format::testPipelinedWriteIdentical()
+{
+    QFETCH(QUuid, cipher);
+    QFETCH(bool, compressed);
+
+    auto db = createLargeDatabase(500);
+    db->setCipher(cipher);
+    db->setCompressionAlgorithm(compressed ? Database::CompressionGZip : Database::CompressionNone);
+    db->setFormatVersion(KeePass2Writer::kdbxVersionRequired(db.data()));
+
+    // Seeds, IV and KDF salt come from the same random sequence for both writes
+    auto writeDatabase = [&db](bool pipelined, QByteArray& output) {
+        MockRandom::setup(new MockRandom(42));
+        QBuffer buffer(&output);
+        buffer.open(QBuffer::WriteOnly);
+        Kdbx4Writer writer;
+        writer.setPipelined(pipelined);
+        bool success = writer.writeDatabase(&buffer, db.data()) && !writer.hasError();
+        MockRandom::teardown();
+        return success;
+    };
+
+    QByteArray serialOutput;
+    QVERIFY(writeDatabase(false, serialOutput));
+    QByteArray pipelinedOutput;
+    QVERIFY(writeDatabase(true, pipelinedOutput));
+
+    QVERIFY(serialOutput.size() > 3 * 1024 * 1024);
+    QCOMPARE(pipelinedOutput.size(), serialOutput.size());
+    QVERIFY(pipelinedOutput == serialOutput);
+}
+
+void TestKdbx4Format::benchmarkPipelinedWrite_data()
+{
+    QTest::addColumn<bool>("pipelined");
+
+    QTest::newRow("serial") << false;
+    QTest::newRow(qPrintable(QString("pipelined (%1 cores)").arg(QThread::idealThreadCount()))) << true;
+}
+
+void TestKdbx4Format::benchmarkPipelinedWrite()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QFETCH(bool, pipelined);
+
+    auto db = createLargeDatabase(50000);
+    db->setFormatVersion(KeePass2Writer::kdbxVersionRequired(db.data()));
+
+    QBENCHMARK
+    {
+        QBuffer buffer;
+        buffer.open(QBuffer::WriteOnly);
+        Kdbx4Writer writer;
+        writer.setPipelined(pipelined);
+        QVERIFY(writer.writeDatabase(&buffer, db.data()));
+    }
+}
+
+void TestKdbx4Format::testReadXmlProtectedValues()
+{
+    // KDBX 3.1 keeps attachments in the XML, so binaries are covered as well
+    auto db = createLargeDatabase(100);
+    auto* entry = db->rootGroup()->entries().first();
+    entry->setPassword(QString::fromUtf8("p\xc3\xa4ssw\xc3\xb6rd \xe2\x82\xac"));
+    entry->attributes()->set("Secret", QString("x").repeated(100000), true);
+    entry->attributes()->set("Empty", "", true);
+
+    const QByteArray streamKey = randomGen()->randomArray(32);
+    KeePass2RandomStream writerStream;
+    QVERIFY(writerStream.init(SymmetricCipher::Salsa20, streamKey));
+    QBuffer buffer;
+    buffer.open(QBuffer::ReadWrite);
+    KdbxXmlWriter writer(KeePass2::FILE_VERSION_3_1);
+    writer.writeDatabase(&buffer, db.data(), &writerStream);
+    QVERIFY(!writer.hasError());
+
+    buffer.seek(0);
+    KeePass2RandomStream readerStream;
+    QVERIFY(readerStream.init(SymmetricCipher::Salsa20, streamKey));
+    auto newDb = QSharedPointer<Database>::create();
+    KdbxXmlReader reader(KeePass2::FILE_VERSION_3_1);
+    reader.readDatabase(&buffer, newDb.data(), &readerStream);
+    QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+
+    const auto entries = db->rootGroup()->entries();
+    const auto newEntries = newDb->rootGroup()->entries();
+    QCOMPARE(newEntries.size(), entries.size());
+    for (int i = 0; i < entries.size(); ++i) {
+        QCOMPARE(newEntries[i]->attributes()->keys(), entries[i]->attributes()->keys());
+        for (const QString& key : entries[i]->attributes()->keys()) {
+            QCOMPARE(newEntries[i]->attributes()->value(key), entries[i]->attributes()->value(key));
+            QCOMPARE(newEntries[i]->attributes()->isProtected(key), entries[i]->attributes()->isProtected(key));
+        }
+        QCOMPARE(newEntries[i]->attachments()->values(), entries[i]->attachments()->values());
+    }
+}
+
+void TestKdbx4Format::benchmarkReadXml()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    auto db = createLargeDatabase(50000);
+    const QByteArray streamKey = randomGen()->randomArray(32);
+    KeePass2RandomStream writerStream;
+    QVERIFY(writerStream.init(SymmetricCipher::Salsa20, streamKey));
+    QBuffer buffer;
+    buffer.open(QBuffer::ReadWrite);
+    KdbxXmlWriter writer(KeePass2::FILE_VERSION_3_1);
+    writer.writeDatabase(&buffer, db.data(), &writerStream);
+    QVERIFY(!writer.hasError());
+
+    QBENCHMARK
+    {
+        buffer.seek(0);
+        KeePass2RandomStream readerStream;
+        QVERIFY(readerStream.init(SymmetricCipher::Salsa20, streamKey));
+        auto newDb = QSharedPointer<Database>::create();
+        KdbxXmlReader reader(KeePass2::FILE_VERSION_3_1);
+        reader.readDatabase(&buffer, newDb.data(), &readerStream);
+        QVERIFY(!reader.hasError());
+    }
+}
@@ -65,6 +65,21 @@ private slots:
     void testUpgradeMasterKeyIntegrity();
     void testUpgradeMasterKeyIntegrity_data();
     void testCustomData();
+    void testPipelinedRead();
+    void testPipelinedRead_data();
+    void benchmarkPipelinedRead();
+    void benchmarkPipelinedRead_data();
+    void testPipelinedWrite();
+    void testPipelinedWrite_data();
+    void testPipelinedWriteIdentical();
+    void testPipelinedWriteIdentical_data();
+    void benchmarkPipelinedWrite();
+    void benchmarkPipelinedWrite_data();
+    void testReadXmlProtectedValues();
+    void benchmarkReadXml();
+
+private:
+    QSharedPointer<Database> createLargeDatabase(int entryCount) const;
 };
 
 #endif // KEEPASSXC_TEST_KDBX4_H
@@ -488,6 +488,44 @@ void TestKeePass2Format::testXmlRepairUuidHistoryItem()
     QCOMPARE(historyItem->uuid(), entry->uuid());
 }
 
+void TestKeePass2Format::testXmlHistoryAttachmentsShared()
+{
+    // The entry and its history item reference equal binaries stored under different pool IDs
+    QByteArray xml("<?xml version=\"1.0\" encoding=\"utf-8\" standalone=\"yes\"?>"
+                   "<KeePassFile><Meta><Binaries>"
+                   "<Binary ID=\"0\">YXR0YWNobWVudA==</Binary>"
+                   "<Binary ID=\"1\">YXR0YWNobWVudA==</Binary>"
+                   "</Binaries></Meta><Root><Group><UUID>YmJiYmJiYmJiYmJiYmJiYg==</UUID><Name>Root</Name>"
+                   "<Entry><UUID>YWFhYWFhYWFhYWFhYWFhYQ==</UUID>"
+                   "<String><Key>Title</Key><Value>new</Value></String>"
+                   "<Binary><Key>file</Key><Value Ref=\"1\"/></Binary>"
+                   "<History><Entry><UUID>YWFhYWFhYWFhYWFhYWFhYQ==</UUID>"
+                   "<String><Key>Title</Key><Value>old</Value></String>"
+                   "<Binary><Key>file</Key><Value Ref=\"0\"/></Binary>"
+                   "</Entry></History></Entry>"
+                   "</Group></Root></KeePassFile>");
+    QBuffer buffer(&xml);
+    buffer.open(QIODevice::ReadOnly);
+
+    bool hasError;
+    QString errorString;
+    auto db = readXml(&buffer, false, hasError, errorString);
+    if (hasError) {
+        qWarning("Database read error: %s", qPrintable(errorString));
+    }
+    QVERIFY(!hasError);
+
+    QCOMPARE(db->rootGroup()->entries().size(), 1);
+    Entry* entry = db->rootGroup()->entries().at(0);
+    QCOMPARE(entry->historyItems().size(), 1);
+    Entry* historyItem = entry->historyItems().at(0);
+
+    QCOMPARE(historyItem->title(), QString("old"));
+    QCOMPARE(historyItem->attachments()->value("file"), QByteArray("attachment"));
+    QCOMPARE(entry->attachments()->value("file"), QByteArray("attachment"));
+    QCOMPARE(historyItem->attachments()->value("file").constData(), entry->attachments()->value("file").constData());
+}
+
 void TestKeePass2Format::testReadBackTargetDb()
 {
     // read back previously constructed KDBX
@@ -87,3 +87,57 @@ void TestKeePass2RandomStream::test()
     QCOMPARE(cipherData, cipherDataEncrypt);
     QCOMPARE(randomStreamData, cipherData);
 }
+
+void TestKeePass2RandomStream::testChunked()
+{
+    const QByteArray key("\x11\x22\x33\x44\x55\x66\x77\x88");
+    QByteArray data(5000, '\0');
+    for (int i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<char>(i * 7);
+    }
+
+    KeePass2RandomStream wholeStream;
+    QVERIFY(wholeStream.init(SymmetricCipher::ChaCha20, key));
+    bool ok;
+    const QByteArray expected = wholeStream.process(data, &ok);
+    QVERIFY(ok);
+    QCOMPARE(expected.size(), data.size());
+
+    // Processing in uneven pieces must consume the key stream the same way
+    KeePass2RandomStream chunkedStream;
+    QVERIFY(chunkedStream.init(SymmetricCipher::ChaCha20, key));
+    QByteArray result = data;
+    int offset = 0;
+    for (int size = 0; offset < result.size(); ++size) {
+        int chunk = qMin(size, result.size() - offset);
+        QVERIFY(chunkedStream.processInPlace(result.data() + offset, chunk));
+        offset += chunk;
+    }
+    QCOMPARE(result, expected);
+
+    QVERIFY(chunkedStream.process({}, &ok).isEmpty());
+    QVERIFY(ok);
+}
+
+void TestKeePass2RandomStream::benchmarkProcess()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    // Protected values are short, a large database has tens of thousands of them
+    QList<QByteArray> values;
+    for (int i = 0; i < 50000; ++i) {
+        values << QByteArray(8 + i % 56, 'x');
+    }
+
+    KeePass2RandomStream randomStream;
+    QVERIFY(randomStream.init(SymmetricCipher::ChaCha20, QByteArray(32, '\x42')));
+
+    QBENCHMARK {
+        for (auto& value : values) {
+            QVERIFY(randomStream.processInPlace(value));
+        }
+    }
+}
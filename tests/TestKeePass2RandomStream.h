@@ -27,6 +27,8 @@ class TestKeePass2RandomStream : public QObject
 private slots:
     void initTestCase();
     void test();
+    void testChunked();
+    void benchmarkProcess();
 };
 
 #endif // KEEPASSX_TESTKEEPASS2RANDOMSTREAM_H
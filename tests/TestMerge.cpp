@@ -1416,6 +1416,114 @@ void TestMerge::testMergeModified()
     QTRY_VERIFY(!modifiedSignalSpy.empty());
 }
 
+/**
+ * Entries are merged in tree order: an entry replaced by its newer source version is moved to the
+ * end of its group before the entries created after it, like the merge always did.
+ */
+void TestMerge::testMergeEntryOrder()
+{
+    QScopedPointer<Database> dbDestination(new Database());
+    auto* group = new Group();
+    group->setUuid(QUuid::createUuid());
+    group->setName("group");
+    group->setParent(dbDestination->rootGroup());
+    QList<Entry*> entries;
+    for (int i = 0; i < 3; ++i) {
+        auto* entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setTitle(QString("entry%1").arg(i));
+        entry->setGroup(group);
+        entries << entry;
+    }
+    QScopedPointer<Database> dbSource(
+        createTestDatabaseStructureClone(dbDestination.data(), Entry::CloneIncludeHistory, Group::CloneIncludeEntries));
+
+    m_clock->advanceSecond(1);
+    entries[0]->beginUpdate();
+    entries[0]->setUsername("older change");
+    entries[0]->endUpdate();
+
+    m_clock->advanceSecond(1);
+    Entry* sourceEntry = dbSource->rootGroup()->findEntryByUuid(entries[0]->uuid());
+    sourceEntry->beginUpdate();
+    sourceEntry->setPassword("newer change");
+    sourceEntry->endUpdate();
+    auto* newEntry = new Entry();
+    newEntry->setUuid(QUuid::createUuid());
+    newEntry->setTitle("new");
+    newEntry->setGroup(dbSource->rootGroup()->findGroupByUuid(group->uuid()));
+
+    Merger merger(dbSource.data(), dbDestination.data());
+    merger.merge();
+
+    QStringList titles;
+    for (const Entry* entry : group->entries()) {
+        titles << entry->title();
+    }
+    QCOMPARE(titles, QStringList({"entry1", "entry2", "entry0", "new"}));
+
+    // The older change of the target is kept in the history of the replaced entry
+    Entry* mergedEntry = group->entries().at(2);
+    QCOMPARE(mergedEntry->password(), QString("newer change"));
+    QCOMPARE(mergedEntry->username(), QString(""));
+    QCOMPARE(mergedEntry->historyItems().size(), 2);
+    QCOMPARE(mergedEntry->historyItems().at(0)->username(), QString(""));
+    QCOMPARE(mergedEntry->historyItems().at(1)->username(), QString("older change"));
+    QCOMPARE(mergedEntry->historyItems().at(1)->password(), QString(""));
+}
+
+void TestMerge::benchmarkMerge_data()
+{
+    QTest::addColumn<int>("numEntries");
+    QTest::newRow("10k entries") << 10000;
+    QTest::newRow("50k entries") << 50000;
+}
+
+void TestMerge::benchmarkMerge()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QFETCH(int, numEntries);
+
+    QScopedPointer<Database> dbSource(createLargeTestDatabase(numEntries));
+    // Give every entry a history so that the merge has to look at it
+    m_clock->advanceSecond(1);
+    const auto entries = dbSource->rootGroup()->entriesRecursive();
+    for (Entry* entry : entries) {
+        entry->beginUpdate();
+        entry->setNotes("notes");
+        entry->endUpdate();
+    }
+    QScopedPointer<Database> dbDestination(
+        createTestDatabaseStructureClone(dbSource.data(), Entry::CloneIncludeHistory, Group::CloneIncludeEntries));
+
+    // Let every tenth entry diverge so the merge has actual work to do
+    m_clock->advanceSecond(1);
+    for (int i = 0; i < entries.size(); i += 10) {
+        entries[i]->beginUpdate();
+        entries[i]->setPassword(QString::number(i));
+        entries[i]->endUpdate();
+    }
+
+    // Only the first merge has anything to do
+    QStringList changes;
+    QBENCHMARK_ONCE
+    {
+        Merger merger(dbSource.data(), dbDestination.data());
+        changes = merger.merge();
+    }
+
+    QCOMPARE(dbDestination->rootGroup()->entriesRecursive().size(), numEntries);
+    QCOMPARE(changes.filter("Synchronizing").size(), (numEntries + 9) / 10);
+    Entry* mergedEntry = dbDestination->rootGroup()->findEntryByUuid(entries[10]->uuid());
+    QVERIFY(mergedEntry);
+    QCOMPARE(mergedEntry->password(), QString("10"));
+    QCOMPARE(mergedEntry->historyItems().size(), 2);
+}
+
 Database* TestMerge::createTestDatabase()
 {
     auto db = new Database();
@@ -1453,6 +1561,31 @@ Database* TestMerge::createTestDatabase()
     return db;
 }
 
+Database* TestMerge::createLargeTestDatabase(int numEntries)
+{
+    auto db = new Database();
+
+    // Spread the entries over 100 groups
+    QList<Group*> groups;
+    for (int i = 0; i < 100; ++i) {
+        auto group = new Group();
+        group->setUuid(QUuid::createUuid());
+        group->setName(QString("group%1").arg(i));
+        group->setParent(db->rootGroup());
+        groups << group;
+    }
+
+    for (int i = 0; i < numEntries; ++i) {
+        auto entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setTitle(QString("entry%1").arg(i));
+        entry->setUsername(QString("user%1").arg(i));
+        entry->setGroup(groups.at(i % groups.size()));
+    }
+
+    return db;
+}
+
 Database* TestMerge::createTestDatabaseStructureClone(Database* source, int entryFlags, int groupFlags)
 {
     auto db = new Database();
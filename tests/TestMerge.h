@@ -55,9 +55,13 @@ private slots:
     void testDeletedGroup();
     void testDeletedRevertedEntry();
     void testDeletedRevertedGroup();
+    void testMergeEntryOrder();
+    void benchmarkMerge_data();
+    void benchmarkMerge();
 
 private:
     Database* createTestDatabase();
+    Database* createLargeTestDatabase(int numEntries);
     Database* createTestDatabaseStructureClone(Database* source, int entryFlags, int groupFlags);
     void testResolveConflictTemplate(int mergeMode,
                                      std::function<void(Database*, const QMap<const char*, QDateTime>&)> verification);
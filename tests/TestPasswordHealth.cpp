@@ -17,7 +17,10 @@
 
 #include "TestPasswordHealth.h"
 
+#include "core/Group.h"
 #include "core/PasswordHealth.h"
+#include "core/PasswordHealthCache.h"
+#include "crypto/Crypto.h"
 
 #include <QTest>
 
@@ -25,6 +28,7 @@ QTEST_GUILESS_MAIN(TestPasswordHealth)
 
 void TestPasswordHealth::initTestCase()
 {
+    QVERIFY(Crypto::init());
 }
 
 void TestPasswordHealth::testNoDb()
@@ -64,3 +68,53 @@ void TestPasswordHealth::testNoDb()
     QVERIFY(excellent.scoreReason().isEmpty());
     QVERIFY(excellent.scoreDetails().isEmpty());
 }
+
+void TestPasswordHealth::testCache()
+{
+    auto db = QSharedPointer<Database>::create();
+    auto* cache = db->passwordHealthCache();
+
+    auto entry1 = new Entry();
+    entry1->setPassword("Yohb2ChR4");
+    entry1->setGroup(db->rootGroup());
+
+    auto entry2 = new Entry();
+    entry2->setPassword("Yohb2ChR4");
+    entry2->setGroup(db->rootGroup());
+
+    auto entry3 = new Entry();
+    entry3->setPassword("MIhIN9UKrgtPL2hp");
+    entry3->setGroup(db->rootGroup());
+
+    QVERIFY(!cache->contains("Yohb2ChR4"));
+    db->setPasswordHealthPrecomputationEnabled(true);
+    cache->waitForPrecomputation();
+    QVERIFY(cache->contains("Yohb2ChR4"));
+    QVERIFY(cache->contains("MIhIN9UKrgtPL2hp"));
+
+    // Cached estimates match a fresh evaluation
+    QCOMPARE(entry1->passwordHealth()->score(), 47);
+    QCOMPARE(entry3->passwordHealth()->score(), 78);
+    QCOMPARE(entry3->passwordHealth()->quality(), PasswordHealth::Quality::Good);
+
+    // Adjustments made by the health checker do not leak into the cache
+    HealthChecker checker(db);
+    QCOMPARE(checker.evaluate(entry1)->score(), 47 - 15);
+    QCOMPARE(checker.evaluate(entry3)->score(), 78);
+    QCOMPARE(cache->health("Yohb2ChR4")->score(), 47);
+
+    // A changed password is estimated again
+    entry3->setPassword("secret");
+    QVERIFY(!cache->contains("secret"));
+    QCOMPARE(entry3->passwordHealth()->score(), 6);
+    QVERIFY(cache->contains("secret"));
+
+    cache->clear();
+    QVERIFY(!cache->contains("Yohb2ChR4"));
+
+    // Locking the database drops the estimates along with their secret
+    QCOMPARE(entry1->passwordHealth()->score(), 47);
+    QVERIFY(cache->contains("Yohb2ChR4"));
+    db->releaseData();
+    QVERIFY(!cache->contains("Yohb2ChR4"));
+}
@@ -23,6 +23,7 @@
 #include <QVector>
 
 #include "crypto/Crypto.h"
+#include "crypto/Random.h"
 #include "format/KeePass2.h"
 #include "streams/SymmetricCipherStream.h"
 
@@ -455,3 +456,128 @@ void TestSymmetricCipher::testStreamReset()
     writer.close();
     QCOMPARE(buffer.buffer().size(), 16);
 }
+
+void TestSymmetricCipher::testStreamRoundTrip_data()
+{
+    QTest::addColumn<SymmetricCipher::Mode>("mode");
+    QTest::addColumn<int>("size");
+
+    const QList<QPair<SymmetricCipher::Mode, QString>> modes = {{SymmetricCipher::Aes256_CBC, "AES256-CBC"},
+                                                                 {SymmetricCipher::Twofish_CBC, "Twofish-CBC"},
+                                                                 {SymmetricCipher::ChaCha20, "ChaCha20"}};
+    // sizes around the cipher block size and the internal buffer size
+    const QList<int> sizes = {1, 15, 16, 17, 65535, 65536, 65537, 65536 * 3 + 16, 1024 * 1024 + 5};
+
+    for (const auto& mode : modes) {
+        for (int size : sizes) {
+            QTest::newRow(qPrintable(QString("%1 %2 bytes").arg(mode.second).arg(size))) << mode.first << size;
+        }
+    }
+}
+
+void TestSymmetricCipher::testStreamRoundTrip()
+{
+    QFETCH(SymmetricCipher::Mode, mode);
+    QFETCH(int, size);
+
+    QByteArray key = randomGen()->randomArray(SymmetricCipher::keySize(mode));
+    QByteArray iv = randomGen()->randomArray(SymmetricCipher::defaultIvSize(mode));
+    QByteArray plainText = randomGen()->randomArray(size);
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::ReadWrite));
+
+    SymmetricCipherStream streamEnc(&buffer);
+    QVERIFY(streamEnc.init(mode, SymmetricCipher::Encrypt, key, iv));
+    QVERIFY(streamEnc.open(QIODevice::WriteOnly));
+    // write in odd-sized pieces to exercise partial buffer fills
+    for (int pos = 0; pos < plainText.size(); pos += 1000) {
+        QByteArray piece = plainText.mid(pos, 1000);
+        QCOMPARE(streamEnc.write(piece), qint64(piece.size()));
+    }
+    streamEnc.close();
+
+    // compare against a single-shot encryption of the whole input
+    QByteArray expected = plainText;
+    SymmetricCipher cipher;
+    QVERIFY(cipher.init(mode, SymmetricCipher::Encrypt, key, iv));
+    if (cipher.blockSize(mode) == 1) {
+        QVERIFY(cipher.process(expected));
+    } else {
+        QVERIFY(cipher.finish(expected));
+    }
+    QCOMPARE(buffer.buffer(), expected);
+
+    buffer.reset();
+    SymmetricCipherStream streamDec(&buffer);
+    QVERIFY(streamDec.init(mode, SymmetricCipher::Decrypt, key, iv));
+    QVERIFY(streamDec.open(QIODevice::ReadOnly));
+    QByteArray decrypted;
+    QByteArray piece;
+    while (!(piece = streamDec.read(777)).isEmpty()) {
+        decrypted.append(piece);
+    }
+    QCOMPARE(decrypted, plainText);
+}
+
+void TestSymmetricCipher::benchmarkStreamThroughput_data()
+{
+    QTest::addColumn<SymmetricCipher::Mode>("mode");
+    QTest::addColumn<SymmetricCipher::Direction>("direction");
+
+    QTest::newRow("AES128-CBC Encrypt") << SymmetricCipher::Aes128_CBC << SymmetricCipher::Encrypt;
+    QTest::newRow("AES128-CBC Decrypt") << SymmetricCipher::Aes128_CBC << SymmetricCipher::Decrypt;
+    QTest::newRow("AES256-CBC Encrypt") << SymmetricCipher::Aes256_CBC << SymmetricCipher::Encrypt;
+    QTest::newRow("AES256-CBC Decrypt") << SymmetricCipher::Aes256_CBC << SymmetricCipher::Decrypt;
+    QTest::newRow("Twofish-CBC Encrypt") << SymmetricCipher::Twofish_CBC << SymmetricCipher::Encrypt;
+    QTest::newRow("Twofish-CBC Decrypt") << SymmetricCipher::Twofish_CBC << SymmetricCipher::Decrypt;
+    QTest::newRow("ChaCha20 Encrypt") << SymmetricCipher::ChaCha20 << SymmetricCipher::Encrypt;
+    QTest::newRow("ChaCha20 Decrypt") << SymmetricCipher::ChaCha20 << SymmetricCipher::Decrypt;
+}
+
+void TestSymmetricCipher::benchmarkStreamThroughput()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QFETCH(SymmetricCipher::Mode, mode);
+    QFETCH(SymmetricCipher::Direction, direction);
+
+    QByteArray key = randomGen()->randomArray(SymmetricCipher::keySize(mode));
+    QByteArray iv = randomGen()->randomArray(SymmetricCipher::defaultIvSize(mode));
+    QByteArray plainText = randomGen()->randomArray(64 * 1024 * 1024);
+
+    // prepare a valid cipher text to decrypt
+    QBuffer cipherBuffer;
+    QVERIFY(cipherBuffer.open(QIODevice::ReadWrite));
+    {
+        SymmetricCipherStream stream(&cipherBuffer);
+        QVERIFY(stream.init(mode, SymmetricCipher::Encrypt, key, iv));
+        QVERIFY(stream.open(QIODevice::WriteOnly));
+        QCOMPARE(stream.write(plainText), qint64(plainText.size()));
+    }
+
+    QBENCHMARK
+    {
+        if (direction == SymmetricCipher::Encrypt) {
+            QBuffer buffer;
+            buffer.open(QIODevice::WriteOnly);
+            SymmetricCipherStream stream(&buffer);
+            stream.init(mode, direction, key, iv);
+            stream.open(QIODevice::WriteOnly);
+            stream.write(plainText);
+            stream.close();
+        } else {
+            cipherBuffer.reset();
+            SymmetricCipherStream stream(&cipherBuffer);
+            stream.init(mode, direction, key, iv);
+            stream.open(QIODevice::ReadOnly);
+            QByteArray chunk(1024 * 1024, Qt::Uninitialized);
+            while (stream.read(chunk.data(), chunk.size()) > 0) {
+            }
+        }
+    }
+}
@@ -39,6 +39,10 @@ private slots:
     void testChaCha20();
     void testPadding();
     void testStreamReset();
+    void testStreamRoundTrip_data();
+    void testStreamRoundTrip();
+    void benchmarkStreamThroughput_data();
+    void benchmarkStreamThroughput();
 };
 
 #endif // KEEPASSX_TESTSYMMETRICCIPHER_H
@@ -18,12 +18,18 @@
 #include "TestGuiPixmaps.h"
 #include "core/Metadata.h"
 
+#include <QBuffer>
+#include <QScrollBar>
+#include <QTemporaryFile>
 #include <QTest>
 
+#include "core/Clock.h"
 #include "core/Group.h"
 #include "crypto/Crypto.h"
 #include "gui/DatabaseIcons.h"
+#include "gui/HtmlExporter.h"
 #include "gui/Icons.h"
+#include "gui/entry/EntryView.h"
 
 void TestGuiPixmaps::initTestCase()
 {
@@ -81,4 +87,152 @@ void TestGuiPixmaps::testGroupIcons()
     QVERIFY(Icons::groupIconPixmap(group).toImage() == Icons::customIconPixmap(db.data(), iconUuid).toImage());
 }
 
+void TestGuiPixmaps::testCustomIconCache()
+{
+    QScopedPointer<Database> db(new Database());
+    auto entry = new Entry();
+    entry->setGroup(db->rootGroup());
+
+    QUuid iconUuid = QUuid::createUuid();
+    QImage icon(2, 1, QImage::Format_RGB32);
+    icon.fill(qRgb(0, 0, 50));
+    db->metadata()->addCustomIcon(iconUuid, Icons::saveToBytes(icon));
+    entry->setIcon(iconUuid);
+
+    // Repeated requests are served from the cache
+    auto pixmap = Icons::entryIconPixmap(entry);
+    QCOMPARE(Icons::entryIconPixmap(entry).cacheKey(), pixmap.cacheKey());
+    QCOMPARE(Icons::customIconPixmap(db.data(), iconUuid).cacheKey(), pixmap.cacheKey());
+    QVERIFY(Icons::entryIconPixmap(entry, IconSize::Large).cacheKey() != pixmap.cacheKey());
+
+    // Badges are cached separately
+    TimeInfo timeInfo = entry->timeInfo();
+    timeInfo.setExpires(true);
+    timeInfo.setExpiryTime(Clock::currentDateTimeUtc().addDays(-1));
+    entry->setTimeInfo(timeInfo);
+    auto expiredPixmap = Icons::entryIconPixmap(entry);
+    QVERIFY(expiredPixmap.cacheKey() != pixmap.cacheKey());
+    QVERIFY(expiredPixmap.toImage() != pixmap.toImage());
+    QCOMPARE(Icons::entryIconPixmap(entry).cacheKey(), expiredPixmap.cacheKey());
+
+    // Changing the custom icons invalidates the cache
+    db->metadata()->removeCustomIcon(iconUuid);
+    QVERIFY(Icons::customIconPixmap(db.data(), iconUuid).isNull());
+    icon.fill(qRgb(50, 0, 0));
+    db->metadata()->addCustomIcon(iconUuid, Icons::saveToBytes(icon));
+    auto newPixmap = Icons::customIconPixmap(db.data(), iconUuid);
+    QVERIFY(newPixmap.toImage() != pixmap.toImage());
+}
+
+void TestGuiPixmaps::testHtmlExportIcons()
+{
+    auto db = QSharedPointer<Database>::create();
+    QUuid iconUuid = QUuid::createUuid();
+    QImage icon(2, 1, QImage::Format_RGB32);
+    icon.fill(qRgb(0, 0, 50));
+    db->metadata()->addCustomIcon(iconUuid, Icons::saveToBytes(icon));
+
+    // More groups than are formatted in one batch, every top level group has a subgroup
+    QStringList expectedOrder;
+    QList<const Entry*> iconEntries;
+    for (int i = 0; i < 80; ++i) {
+        auto group = new Group();
+        group->setName(QString("Group %1").arg(i, 3, 10, QChar('0')));
+        group->setParent(db->rootGroup());
+        auto subgroup = new Group();
+        subgroup->setName(QString("Subgroup %1").arg(i, 3, 10, QChar('0')));
+        subgroup->setParent(group);
+
+        for (auto* parent : {group, subgroup}) {
+            expectedOrder << "&rarr; " + parent->name() + "</h2>";
+            for (int j = 0; j < 3; ++j) {
+                auto entry = new Entry();
+                entry->setTitle(QString("%1 Entry %2").arg(parent->name()).arg(j));
+                entry->setUsername("user");
+                if (j == 2) {
+                    entry->setIcon(iconUuid);
+                } else {
+                    entry->setIcon(j);
+                }
+                entry->setGroup(parent);
+                expectedOrder << "<caption>" + entry->title() + "</caption>";
+                if (iconEntries.size() < 3) {
+                    iconEntries << entry;
+                }
+            }
+        }
+    }
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    HtmlExporter exporter;
+    QVERIFY2(exporter.exportDatabase(file.fileName(), db, false), qPrintable(exporter.errorString()));
+    QVERIFY(file.seek(0));
+    const auto html = QString::fromUtf8(file.readAll());
+
+    // Two standard entry icons, the custom icon and the group icon
+    QCOMPARE(html.count("data:image/png;base64,"), 4);
+    QList<QPixmap> pixmaps;
+    for (const auto* entry : iconEntries) {
+        pixmaps << Icons::entryIconPixmap(entry, IconSize::Medium);
+    }
+    pixmaps << Icons::groupIconPixmap(db->rootGroup()->children().first(), IconSize::Medium);
+    for (const auto& pixmap : pixmaps) {
+        QByteArray png;
+        QBuffer buffer(&png);
+        pixmap.save(&buffer, "PNG");
+        QCOMPARE(html.count(QString::fromLatin1(png.toBase64())), 1);
+    }
+
+    // Every entry refers to its icon class instead
+    QCOMPARE(html.count("<td width=\"1%\"><span class=\"icon icon"), 80 * 2 * 3);
+
+    // Groups and entries are written in tree order, across all batches
+    int pos = 0;
+    for (const auto& expected : expectedOrder) {
+        int next = html.indexOf(expected, pos);
+        QVERIFY2(next >= pos, qPrintable(expected));
+        pos = next + expected.size();
+    }
+}
+
+void TestGuiPixmaps::benchmarkEntryViewScroll()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QScopedPointer<Database> db(new Database());
+    QList<QUuid> iconUuids;
+    for (int i = 0; i < 500; ++i) {
+        QImage icon(32, 32, QImage::Format_RGB32);
+        icon.fill(qRgb(i % 256, i / 256, 128));
+        iconUuids << QUuid::createUuid();
+        db->metadata()->addCustomIcon(iconUuids.last(), Icons::saveToBytes(icon));
+    }
+
+    for (int i = 0; i < 20000; ++i) {
+        auto entry = new Entry();
+        entry->setTitle(QString("Entry %1").arg(i));
+        entry->setIcon(iconUuids[i % iconUuids.size()]);
+        entry->setGroup(db->rootGroup());
+    }
+
+    EntryView view;
+    view.resize(800, 600);
+    view.displayGroup(db->rootGroup());
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+    auto scrollBar = view.verticalScrollBar();
+    QBENCHMARK
+    {
+        for (int value = scrollBar->minimum(); value <= scrollBar->maximum(); value += scrollBar->pageStep()) {
+            scrollBar->setValue(value);
+            view.viewport()->repaint();
+        }
+    }
+}
+
 QTEST_MAIN(TestGuiPixmaps)
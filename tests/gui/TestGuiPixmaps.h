@@ -29,6 +29,9 @@ private slots:
     void testDatabaseIcons();
     void testEntryIcons();
     void testGroupIcons();
+    void testCustomIconCache();
+    void testHtmlExportIcons();
+    void benchmarkEntryViewScroll();
 };
 
 #endif // KEEPASSX_TESTGUIPIXMAPS_H
@@ -0,0 +1,43 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_MOCKRANDOM_H
+#define KEEPASSXC_MOCKRANDOM_H
+
+#include "crypto/Random.h"
+
+#include <random>
+
+/**
+ * Deterministic random generator, every instance created with the same seed
+ * produces the same byte sequence through randomize() and randomArray().
+ */
+class MockRandom : public Random
+{
+public:
+    explicit MockRandom(quint32 seed);
+
+    void randomize(QByteArray& ba) override;
+
+    static void setup(Random* random);
+    static void teardown();
+
+private:
+    std::mt19937 m_generator;
+};
+
+#endif // KEEPASSXC_MOCKRANDOM_H